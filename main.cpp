@@ -11,6 +11,55 @@
 #include <fstream>
 #include <optional>
 #include <chrono>
+#include <condition_variable>
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cctype>
+#include <cmath>
+#include <csignal>
+#include <ctime>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <sys/statvfs.h>
+#include <sys/sysmacros.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <sys/wait.h>
+#include <sys/epoll.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <linux/aio_abi.h>
+#include <linux/errqueue.h>
+#include <linux/perf_event.h>
+#include <linux/fs.h>
+#include <linux/io_uring.h>
 
 // -----------------------------
 // App metadata
@@ -35,172 +84,3865 @@ static QString timestamp() {
     return QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss");
 }
 
-static bool which(const QString& exe, QString* outPath=nullptr) {
-    QProcess proc;
-    proc.start("bash", {"-lc", "command -v " + exe});
-    proc.waitForFinished(1500);
-    auto path = QString::fromLocal8Bit(proc.readAllStandardOutput()).trimmed();
-    bool ok = !path.isEmpty();
-    if (ok && outPath) *outPath = path;
-    return ok;
+// Latency in ns -> short human string ("850 ns", "12.3 µs", "4.56 ms").
+static QString fmtNs(double ns) {
+    if (ns < 1e3) return QString("%1 ns").arg(qint64(ns));
+    if (ns < 1e6) return QString("%1 µs").arg(ns/1e3, 0, 'f', 1);
+    if (ns < 1e9) return QString("%1 ms").arg(ns/1e6, 0, 'f', 2);
+    return QString("%1 s").arg(ns/1e9, 0, 'f', 2);
+}
+
+// Runs a short query command and returns stdout+stderr ("" if it could not run).
+static QString toolOutput(const QString& exe, const QStringList& args, int timeoutMs=3000) {
+    QProcess proc;
+    proc.setProcessChannelMode(QProcess::MergedChannels);
+    proc.start(exe, args);
+    if (!proc.waitForFinished(timeoutMs)) { proc.kill(); proc.waitForFinished(500); return {}; }
+    return QString::fromLocal8Bit(proc.readAllStandardOutput());
+}
+
+// toolOutput() without blocking the event loop: `done` runs on ctx's thread
+// with stdout+stderr ("" if the command could not run or took too long).
+static void toolOutputAsync(QObject* ctx, const QString& exe, const QStringList& args,
+                            std::function<void(const QString&)> done, int timeoutMs=3000) {
+    auto* proc = new QProcess(ctx);
+    proc->setProcessChannelMode(QProcess::MergedChannels);
+    QObject::connect(proc, &QProcess::finished, ctx, [proc, done](int, QProcess::ExitStatus st) {
+        done(st == QProcess::NormalExit ? QString::fromLocal8Bit(proc->readAllStandardOutput()) : QString());
+        proc->deleteLater();
+    });
+    QObject::connect(proc, &QProcess::errorOccurred, ctx, [proc, done](QProcess::ProcessError e) {
+        if (e != QProcess::FailedToStart) return;   // the others are followed by finished()
+        done({});
+        proc->deleteLater();
+    });
+    QTimer::singleShot(timeoutMs, proc, [proc] { proc->kill(); });
+    proc->start(exe, args);
+}
+
+static bool which(const QString& exe, QString* outPath=nullptr) {
+    QProcess proc;
+    proc.start("bash", {"-lc", "command -v " + exe});
+    proc.waitForFinished(1500);
+    auto path = QString::fromLocal8Bit(proc.readAllStandardOutput()).trimmed();
+    bool ok = !path.isEmpty();
+    if (ok && outPath) *outPath = path;
+    return ok;
+}
+
+// -----------------------------
+// DonutGauge (compact semicircle)
+// -----------------------------
+
+class DonutGauge : public QWidget {
+    Q_OBJECT
+public:
+    explicit DonutGauge(QWidget* parent=nullptr)
+        : QWidget(parent)
+    {
+        setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+        setFixedSize(200, 160);
+    }
+
+    QSize sizeHint() const override { return {200,160}; }
+
+    void setLabel(const QString& t) { m_label = t; update(); }
+    void setArcColor(const QColor& c) { m_arc = c; update(); }
+    void setTrackColor(const QColor& c) { m_track = c; update(); }
+    void setTextColor(const QColor& c) { m_text = c; update(); }
+    void setCaptionColor(const QColor& c) { m_caption = c; update(); }
+    void setCaptionColorCoded(bool on) { m_captionColorCoded = on; update(); }
+
+    void setValue(double v, const QString& cap) {
+        m_value = std::clamp(v, 0.0, 1.0);
+        m_captionText = cap;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) override {
+        QPainter p(this);
+        p.setRenderHint(QPainter::Antialiasing, true);
+
+        const int pad = 10;
+        const int labelBand = 22;
+        const int arcw = 14;
+
+        QRectF arcRect(pad, pad + labelBand,
+                       width() - 2*pad,
+                       std::min(height()*2 - 2*pad, width() - 2*pad));
+
+        // Label (above arc)
+        p.setPen(m_text);
+        QFont f = font(); f.setBold(true); f.setPointSize(10);
+        p.setFont(f);
+        p.drawText(QRect(0, pad, width(), 16), Qt::AlignHCenter|Qt::AlignVCenter, m_label);
+
+        // Track
+        QPen trackPen(m_track, arcw);
+        trackPen.setCapStyle(Qt::RoundCap);
+        p.setPen(trackPen);
+        // use 280 degrees sweep starting at 280
+        p.drawArc(arcRect, 16*280, 16*280);
+
+        // Value arc
+        QPen arcPen(m_arc, arcw);
+        arcPen.setCapStyle(Qt::RoundCap);
+        p.setPen(arcPen);
+        int extent = int(280.0 * m_value);
+        p.drawArc(arcRect, 16*280, 16*extent);
+
+        // Center percent
+        QFont fv = font(); fv.setBold(true); fv.setPointSize(12);
+        p.setFont(fv);
+        p.setPen(m_text);
+        QString pct = QString::number(int(std::round(m_value*100))) + "%";
+        QPoint center(width()/2, int(arcRect.top() + arcRect.height()*0.55));
+        p.drawText(QRect(center.x()-60, center.y()-12, 120, 24), Qt::AlignCenter, pct);
+
+        // Caption
+        p.setFont(font());
+        p.setPen(m_captionColorCoded ? m_arc : m_caption);
+        p.drawText(QRect(0, height()-18, width(), 16), Qt::AlignHCenter|Qt::AlignVCenter, m_captionText);
+    }
+
+private:
+    QString m_label, m_captionText;
+    QColor  m_arc  = QColor("#84cc16");
+    QColor  m_track= QColor("#c7ced6");
+    QColor  m_text = Qt::black;
+    QColor  m_caption = Qt::black;
+    bool    m_captionColorCoded = false;
+    double  m_value = 0.0;
+};
+
+// -----------------------------
+// Per-core strip (one row per core, one column per refresh, newest at the right)
+// -----------------------------
+
+class CoreStripWidget : public QWidget {
+    Q_OBJECT
+public:
+    explicit CoreStripWidget(QWidget* parent=nullptr)
+        : QWidget(parent)
+    {
+        setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+        setFixedSize(200, 160);
+    }
+
+    QSize sizeHint() const override { return {200,160}; }
+
+    void setLabel(const QString& t) { m_label = t; update(); }
+    void setTrackColor(const QColor& c) { m_track = c; m_img = QImage(); update(); }
+    void setTextColor(const QColor& c) { m_text = c; update(); }
+
+    // Utilization 0..1 per core; the image scrolls left by one column
+    void appendColumn(const float* util, int cores) {
+        if (cores <= 0) return;
+        if (m_img.isNull() || m_img.height() != cores) {
+            m_img = QImage(kColumns, cores, QImage::Format_RGB32);
+            m_img.fill(m_track);
+        }
+        for (int c = 0; c < cores; ++c) {
+            auto* row = reinterpret_cast<QRgb*>(m_img.scanLine(c));
+            std::memmove(row, row + 1, sizeof(QRgb) * (kColumns - 1));
+            row[kColumns - 1] = color(util[c]);
+        }
+        m_cores = cores;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) override {
+        QPainter p(this);
+        const int pad = 10, labelBand = 22;
+        QFont f = font(); f.setBold(true); f.setPointSize(10);
+        p.setFont(f);
+        p.setPen(m_text);
+        p.drawText(QRect(0, pad, width(), 16), Qt::AlignHCenter|Qt::AlignVCenter,
+                   m_cores ? QString("%1 (%2)").arg(m_label).arg(m_cores) : m_label);
+        const QRect area(pad, pad + labelBand, width() - 2*pad, height() - 2*pad - labelBand);
+        if (m_img.isNull()) { p.fillRect(area, m_track); return; }
+        p.drawImage(area, m_img);
+    }
+
+private:
+    static constexpr int kColumns = 240;
+    // Track colour when idle, through green and amber to red when saturated
+    QRgb color(float u) const {
+        u = std::clamp(u, 0.0f, 1.0f);
+        if (u < 0.02f) return m_track.rgb();
+        return QColor::fromHsvF(0.33 * (1.0 - u), 0.85, 0.55 + 0.4 * u).rgb();
+    }
+
+    QString m_label;
+    QImage  m_img;
+    int     m_cores = 0;
+    QColor  m_track = QColor("#c7ced6");
+    QColor  m_text  = Qt::black;
+};
+
+// -----------------------------
+// Heatmap (rows x columns of values, green = good)
+// -----------------------------
+
+class HeatmapWidget : public QWidget {
+    Q_OBJECT
+public:
+    explicit HeatmapWidget(QWidget* parent=nullptr)
+        : QWidget(parent)
+    {
+        setMinimumSize(360, 200);
+    }
+
+    void setTitle(const QString& t) { m_title = t; update(); }
+    void setTextColor(const QColor& c) { m_text = c; update(); }
+    // Latency-like metrics: lower is better and the scale is logarithmic.
+    void setLowerIsBetter(bool on) { m_lowerBetter = on; update(); }
+    void setFormatter(std::function<QString(double)> f) { m_fmt = std::move(f); update(); }
+
+    // Columns may be grouped under a shared header ("seq" over 0..100).
+    void setAxes(const QStringList& rows, const QStringList& cols, const QStringList& groups = {}) {
+        m_rows = rows; m_cols = cols; m_groups = groups;
+        m_values.assign(size_t(rows.size()*cols.size()), std::nan(""));
+        update();
+    }
+    void clearValues() { std::fill(m_values.begin(), m_values.end(), std::nan("")); update(); }
+    void setValue(int row, int col, double v) {
+        if (row < 0 || col < 0 || row >= m_rows.size() || col >= m_cols.size()) return;
+        m_values[size_t(row*m_cols.size() + col)] = v;
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent*) override {
+        QPainter p(this);
+        p.setRenderHint(QPainter::Antialiasing, false);
+        const int left = 44, titleH = 18, headH = m_groups.isEmpty() ? 16 : 32;
+        const int top = titleH + headH;
+        if (m_rows.isEmpty() || m_cols.isEmpty()) return;
+        const double cw = double(width() - left - 4) / m_cols.size();
+        const double ch = double(height() - top - 4) / m_rows.size();
+
+        double lo = INFINITY, hi = 0;
+        for (double v : m_values) if (v > 0) { lo = std::min(lo, v); hi = std::max(hi, v); }
+
+        QFont f = font(); f.setBold(true); p.setFont(f);
+        p.setPen(m_text);
+        p.drawText(QRect(0, 0, width(), titleH), Qt::AlignHCenter|Qt::AlignVCenter, m_title);
+        QFont small = font(); small.setPointSize(std::max(7, small.pointSize()-1)); p.setFont(small);
+
+        if (!m_groups.isEmpty()) {
+            const int per = m_cols.size() / m_groups.size();
+            for (int g = 0; g < m_groups.size(); ++g)
+                p.drawText(QRectF(left + g*per*cw, titleH, per*cw, 16), Qt::AlignCenter, m_groups[g]);
+        }
+        for (int c = 0; c < m_cols.size(); ++c)
+            p.drawText(QRectF(left + c*cw, top - 16, cw, 16), Qt::AlignCenter, m_cols[c]);
+        for (int r = 0; r < m_rows.size(); ++r)
+            p.drawText(QRectF(0, top + r*ch, left - 4, ch), Qt::AlignRight|Qt::AlignVCenter, m_rows[r]);
+
+        for (int r = 0; r < m_rows.size(); ++r) {
+            for (int c = 0; c < m_cols.size(); ++c) {
+                QRectF cell(left + c*cw + 1, top + r*ch + 1, cw - 2, ch - 2);
+                double v = m_values[size_t(r*m_cols.size() + c)];
+                if (std::isnan(v)) { p.fillRect(cell, QColor(128,128,128,40)); continue; }
+                double t = 0.5;
+                if (hi > lo) t = m_lowerBetter ? 1.0 - std::log(v/lo) / std::log(hi/lo) : (v - lo) / (hi - lo);
+                p.fillRect(cell, QColor::fromHsvF(std::clamp(t, 0.0, 1.0) * 0.33, 0.65, 0.92));
+                p.setPen(Qt::black);
+                p.drawText(cell, Qt::AlignCenter, m_fmt ? m_fmt(v) : QString::number(v, 'f', 0));
+            }
+        }
+    }
+
+private:
+    QString m_title;
+    QStringList m_rows, m_cols, m_groups;
+    std::vector<double> m_values;
+    std::function<QString(double)> m_fmt;
+    QColor m_text = Qt::black;
+    bool m_lowerBetter = false;
+};
+
+// -----------------------------
+// Time-series chart (x = seconds into the run)
+// -----------------------------
+
+class TimeSeriesWidget : public QWidget {
+    Q_OBJECT
+public:
+    explicit TimeSeriesWidget(QWidget* parent=nullptr)
+        : QWidget(parent)
+    {
+        setMinimumSize(300, 140);
+    }
+
+    void setTitle(const QString& t) { m_title = t; update(); }
+    void setTextColor(const QColor& c) { m_text = c; update(); }
+    void setFormatter(std::function<QString(double)> f) { m_fmt = std::move(f); update(); }
+    void setXUnit(const QString& u) { m_xUnit = u; update(); }
+
+    int addSeries(const QString& name, const QColor& color) {
+        m_series.push_back({name, color, {}});
+        return int(m_series.size()) - 1;
+    }
+    void append(int series, double t, double v) {
+        if (series < 0 || series >= int(m_series.size()) || std::isnan(v)) return;
+        m_series[size_t(series)].points.append(QPointF(t, v));
+        update();
+    }
+    void clearPoints() { for (auto& s : m_series) s.points.clear(); update(); }
+
+protected:
+    void paintEvent(QPaintEvent*) override {
+        QPainter p(this);
+        const int left = 56, right = 8, titleH = 18, bottom = 18;
+        const QRectF plot(left, titleH + 2, width() - left - right, height() - titleH - bottom - 4);
+
+        QFont f = font(); f.setBold(true); p.setFont(f);
+        p.setPen(m_text);
+        p.drawText(QRect(0, 0, width(), titleH), Qt::AlignHCenter|Qt::AlignVCenter, m_title);
+        QFont small = font(); small.setPointSize(std::max(7, small.pointSize()-1)); p.setFont(small);
+
+        double tMax = 1, vMax = 0;
+        for (const auto& s : m_series)
+            for (const auto& pt : s.points) { tMax = std::max(tMax, pt.x()); vMax = std::max(vMax, pt.y()); }
+        if (vMax <= 0) vMax = 1;
+        vMax *= 1.1;
+
+        QColor grid = m_text; grid.setAlpha(40);
+        for (int i = 0; i <= 4; ++i) {
+            const double y = plot.bottom() - plot.height() * i / 4;
+            p.setPen(grid); p.drawLine(QPointF(plot.left(), y), QPointF(plot.right(), y));
+            p.setPen(m_text);
+            const double v = vMax * i / 4;
+            p.drawText(QRectF(0, y - 8, left - 4, 16), Qt::AlignRight|Qt::AlignVCenter,
+                       m_fmt ? m_fmt(v) : QString::number(v, 'g', 3));
+        }
+        p.drawText(QRectF(plot.left(), plot.bottom() + 2, plot.width(), bottom), Qt::AlignRight|Qt::AlignTop,
+                   QString("%1 %2").arg(tMax, 0, 'f', 0).arg(m_xUnit));
+
+        p.setRenderHint(QPainter::Antialiasing, true);
+        int legendX = int(plot.left()) + 4;
+        for (const auto& s : m_series) {
+            if (s.points.isEmpty()) continue;
+            QPolygonF line;
+            for (const auto& pt : s.points)
+                line << QPointF(plot.left() + plot.width() * pt.x() / tMax, plot.bottom() - plot.height() * pt.y() / vMax);
+            p.setPen(QPen(s.color, 1.6));
+            p.drawPolyline(line);
+            if (m_series.size() > 1) {
+                p.drawText(QPointF(legendX, plot.top() + 12), s.name);
+                legendX += p.fontMetrics().horizontalAdvance(s.name) + 12;
+            }
+        }
+    }
+
+private:
+    struct Series { QString name; QColor color; QVector<QPointF> points; };
+    QString m_title;
+    std::vector<Series> m_series;
+    std::function<QString(double)> m_fmt;
+    QString m_xUnit = "s";
+    QColor m_text = Qt::black;
+};
+
+// -----------------------------
+// Lightweight system monitor (Linux)
+// -----------------------------
+
+static uint64_t monoNs() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec)*1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+// /proc files stay open and are re-read with pread(…, 0) into a fixed buffer,
+// and the parsers below scan that buffer in place: sampling allocates nothing.
+template<size_t N>
+class ProcFile {
+public:
+    explicit ProcFile(const char* path) : m_fd(::open(path, O_RDONLY|O_CLOEXEC)) {}
+    ~ProcFile() { if (m_fd >= 0) ::close(m_fd); }
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    // NUL-terminated contents, or nullptr. Longer files are truncated to N-1 bytes;
+    // every reader here only needs the head of the file.
+    const char* read() {
+        if (m_fd < 0) return nullptr;
+        const ssize_t n = ::pread(m_fd, m_buf, N - 1, 0);
+        if (n <= 0) return nullptr;
+        m_buf[n] = '\0';
+        return m_buf;
+    }
+private:
+    int m_fd;
+    char m_buf[N];
+};
+
+static uint64_t scanU64(const char*& p) {
+    while (*p == ' ' || *p == '\t') ++p;
+    uint64_t v = 0;
+    for (; *p >= '0' && *p <= '9'; ++p) v = v*10 + uint64_t(*p - '0');
+    return v;
+}
+
+// Value of "key: N kB"-style line, 0 if absent
+static uint64_t procKey(const char* buf, const char* key) {
+    const size_t len = std::strlen(key);
+    for (const char* p = buf; p && *p; ) {
+        if (std::strncmp(p, key, len) == 0 && p[len] == ':') { p += len + 1; return scanU64(p); }
+        p = std::strchr(p, '\n');
+        if (p) ++p;
+    }
+    return 0;
+}
+
+using ProcStat = ProcFile<65536>;      // cpu lines come first; the long intr line may be cut
+using ProcMeminfo = ProcFile<8192>;
+
+// Utilization between consecutive /proc/stat reads, for the aggregate "cpu"
+// line and every "cpuN" line (offline cores simply keep their last value).
+class CpuMeter {
+public:
+    static constexpr int kMaxCores = 256;
+
+    bool sample(ProcStat& f) {
+        const char* p = f.read();
+        if (!p) return false;
+        while (std::strncmp(p, "cpu", 3) == 0) {
+            p += 3;
+            Ticks* slot = &m_total; double* out = &m_totalPct;
+            if (*p != ' ') {
+                const int n = int(scanU64(p));
+                if (n >= kMaxCores) { p = std::strchr(p, '\n'); if (!p) break; ++p; continue; }
+                slot = &m_core[n]; out = &m_corePct[n];
+                m_cores = std::max(m_cores, n + 1);
+            }
+            uint64_t v[8];
+            for (auto& x : v) x = scanU64(p);   // user nice system idle iowait irq softirq steal
+            const Ticks now { v[0]+v[1]+v[2]+v[5]+v[6]+v[7], v[0]+v[1]+v[2]+v[3]+v[4]+v[5]+v[6]+v[7] };
+            if (slot->all && now.all > slot->all)
+                *out = 100.0 * double(now.busy - slot->busy) / double(now.all - slot->all);
+            *slot = now;
+            p = std::strchr(p, '\n');
+            if (!p) break;
+            ++p;
+        }
+        return true;
+    }
+    double total() const { return m_totalPct; }
+    int cores() const { return m_cores; }
+    double core(int i) const { return m_corePct[i]; }
+
+private:
+    struct Ticks { uint64_t busy = 0, all = 0; };
+    Ticks  m_total;
+    double m_totalPct = 0;
+    std::array<Ticks, kMaxCores>  m_core{};
+    std::array<double, kMaxCores> m_corePct{};
+    int m_cores = 0;
+};
+
+// Pressure stall information: the share of wall time in which some task waited
+// on the resource, from the cumulative "some ... total=<us>" counter divided by
+// the real (monotonic) interval between reads. Negative when PSI is unavailable.
+class PsiMeter {
+public:
+    explicit PsiMeter(const char* path) : m_file(path) {}
+    double sample(uint64_t tNs) {
+        const char* p = m_file.read();
+        if (!p || !(p = std::strstr(p, "total="))) return -1;
+        p += 6;
+        const uint64_t totalUs = scanU64(p);
+        double pct = -1;
+        if (m_prevNs && tNs > m_prevNs)
+            pct = std::min(100.0, 100.0 * double(totalUs - m_prevUs) * 1e3 / double(tNs - m_prevNs));
+        m_prevNs = tNs; m_prevUs = totalUs;
+        return pct;
+    }
+private:
+    ProcFile<256> m_file;
+    uint64_t m_prevNs = 0, m_prevUs = 0;
+};
+
+static double memPercent(ProcMeminfo& f, double* usedGiB=nullptr, double* totalGiB=nullptr) {
+    const char* buf = f.read();
+    if (!buf) return 0.0;
+    const uint64_t MemTotal = procKey(buf, "MemTotal");
+    uint64_t avail_kB = procKey(buf, "MemAvailable");
+    if (!avail_kB)   // pre-3.14 kernels: estimate it the way free(1) used to
+        avail_kB = procKey(buf, "MemFree") + procKey(buf, "Buffers") + procKey(buf, "Cached")
+                 + procKey(buf, "SReclaimable") - procKey(buf, "Shmem");
+    double used_kB = double(MemTotal) - double(avail_kB);
+    double pct = (MemTotal == 0) ? 0.0 : (used_kB / double(MemTotal)) * 100.0;
+
+    if (usedGiB)  *usedGiB = used_kB/1024.0/1024.0;
+    if (totalGiB) *totalGiB = MemTotal/1024.0/1024.0;
+    return pct;
+}
+
+static double rootDiskPercent(double* usedGiB=nullptr, double* totalGiB=nullptr) {
+    struct statvfs s{};
+    if (statvfs("/", &s) != 0) return 0.0;
+    unsigned long long total = s.f_blocks * (unsigned long long)s.f_frsize;
+    unsigned long long avail = s.f_bavail * (unsigned long long)s.f_frsize;
+    unsigned long long used  = total - avail;
+    if (total == 0) return 0.0;
+    if (usedGiB)  *usedGiB  = used / (1024.0*1024.0*1024.0);
+    if (totalGiB) *totalGiB = total / (1024.0*1024.0*1024.0);
+    return (double)used / (double)total * 100.0;
+}
+
+// --- Sampler thread ---
+// Sampling runs off the GUI thread so a saturated event loop (CPU stress on
+// every core) cannot delay or skew it; the UI drains whatever has arrived.
+
+static constexpr int kMaxSampleHz = 1000;
+
+struct SysSample {
+    uint64_t tNs = 0;                 // CLOCK_MONOTONIC at the time of the sample
+    double cpu = 0, mem = 0, disk = 0;
+    double memUsedGiB = 0, memTotalGiB = 0, diskUsedGiB = 0, diskTotalGiB = 0;
+    double cpuStall = -1, ioStall = -1, memStall = -1;  // PSI "some", percent of wall time
+    uint16_t cores = 0;
+    std::array<uint8_t, CpuMeter::kMaxCores> core{};   // per-core utilization, percent
+};
+
+// Single producer / single consumer; a full ring drops the new element
+// rather than ever blocking the producer.
+template<class T, size_t N>
+class SpscRing {
+    static_assert(N && (N & (N-1)) == 0, "ring size must be a power of two");
+public:
+    bool push(const T& v) {
+        const size_t h = m_head.load(std::memory_order_relaxed);
+        if (h - m_tail.load(std::memory_order_acquire) == N) return false;
+        m_buf[h & (N-1)] = v;
+        m_head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+    bool pop(T& v) {
+        const size_t t = m_tail.load(std::memory_order_relaxed);
+        if (t == m_head.load(std::memory_order_acquire)) return false;
+        v = m_buf[t & (N-1)];
+        m_tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+private:
+    std::array<T, N> m_buf{};
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
+
+// --- Time-series store ---
+// Bounded history for multi-day runs: raw samples for the last few minutes
+// (trimmed by age; the ring is sized for the maximum sample rate) plus
+// min/max/avg rollups at 10 s, 1 min and 10 min. Every tier is a ring
+// allocated up front, so memory (about 11 MiB) does not grow with run length.
+
+enum SysMetric { MetricCpu, MetricMem, MetricDisk, MetricCpuStall, MetricIoStall, MetricMemStall, kSysMetrics };
+static const char* const kSysMetricNames[kSysMetrics] = {"cpu_pct", "mem_pct", "disk_pct",
+                                                         "cpu_stall_pct", "io_stall_pct", "mem_stall_pct"};
+
+struct StorePoint {
+    uint64_t tNs = 0;              // sample time (raw) or bucket start (rollups)
+    uint32_t n = 0;                // samples folded in
+    std::array<uint32_t, kSysMetrics> valid{};   // of those, how many had the metric (PSI may not)
+    std::array<float, kSysMetrics> min{}, max{}, avg{};
+
+    void merge(const StorePoint& o) {
+        for (int m = 0; m < kSysMetrics; ++m) {
+            if (!o.valid[m]) continue;
+            if (!valid[m]) { min[m] = o.min[m]; max[m] = o.max[m]; avg[m] = o.avg[m]; }
+            else {
+                min[m] = std::fmin(min[m], o.min[m]);
+                max[m] = std::fmax(max[m], o.max[m]);
+                avg[m] = float((double(avg[m]) * valid[m] + double(o.avg[m]) * o.valid[m]) / double(valid[m] + o.valid[m]));
+            }
+            valid[m] += o.valid[m];
+        }
+        n += o.n;
+    }
+};
+
+// Overwrites the oldest element when full; popFront() retires it early
+template<class T>
+class FixedRing {
+public:
+    explicit FixedRing(size_t capacity) : m_buf(capacity) {}
+    void push(const T& v) {
+        m_buf[m_head % m_buf.size()] = v;
+        if (++m_head - m_tail > m_buf.size()) ++m_tail;
+    }
+    void popFront() { if (m_tail < m_head) ++m_tail; }
+    size_t size() const { return m_head - m_tail; }
+    const T& at(size_t i) const { return m_buf[(m_tail + i) % m_buf.size()]; }   // 0 = oldest
+private:
+    std::vector<T> m_buf;
+    size_t m_head = 0, m_tail = 0;
+};
+
+class TimeSeriesStore {
+public:
+    static constexpr int kRawMinutes = 5;
+    static constexpr uint64_t kRawWindowNs = (uint64_t(kRawMinutes) * 60 + 10) * 1000000000ull;
+    static constexpr int kTiers = 4;                     // raw, 10 s, 1 min, 10 min
+    static constexpr const char* kTierNames[kTiers] = {"raw", "10s", "1m", "10m"};
+
+    TimeSeriesStore()
+        : m_raw(size_t(kRawWindowNs / 1000000000ull) * kMaxSampleHz),
+          m_tiers{{ {10'000000000ull, 8640},       // 24 h
+                    {60'000000000ull, 4320},       // 72 h
+                    {600'000000000ull, 4320} }}    // 30 days
+    {}
+
+    void add(const SysSample& s) {
+        Raw r;
+        r.tNs = s.tNs;
+        r.v = {float(s.cpu), float(s.mem), float(s.disk), stall(s.cpuStall), stall(s.ioStall), stall(s.memStall)};
+        m_raw.push(r);
+        // The raw tier is a time window whatever the rate; the slack keeps a
+        // full-window query on raw samples rather than the 10 s rollup
+        while (r.tNs - m_raw.at(0).tNs > kRawWindowNs) m_raw.popFront();
+        if (!m_firstNs) m_firstNs = r.tNs;
+        StorePoint p = point(r);
+        for (auto& t : m_tiers)
+            if (!t.add(p, p)) break;    // a closed bucket cascades into the next coarser tier
+    }
+
+    // Reading is split so a shared store is locked only for a copy: slice() copies
+    // one tier's points within [fromNs, toNs] (raw samples stay in their compact
+    // form), and forEach() / downsample() work on that copy without the store.
+    struct Raw { uint64_t tNs = 0; std::array<float, kSysMetrics> v{}; };
+    struct Slice {
+        std::vector<Raw> raw;
+        std::vector<StorePoint> points;
+    };
+
+    // The finest tier that still reaches back to fromNs
+    int tierFor(uint64_t fromNs) const {
+        const uint64_t reach = std::max(fromNs, m_firstNs);   // nothing older exists anywhere
+        int tier = 0;
+        while (tier < kTiers - 1 && (oldest(tier) > reach || tierSize(tier) == 0)) ++tier;
+        return tier;
+    }
+
+    // Oldest to newest; rollup tiers end with their still-open bucket
+    Slice slice(int tier, uint64_t fromNs, uint64_t toNs) const {
+        Slice out;
+        if (tier == 0) { copyRange(m_raw, fromNs, toNs, out.raw); return out; }
+        const Tier& t = m_tiers[size_t(tier - 1)];
+        copyRange(t.ring, fromNs, toNs, out.points);
+        if (t.open.n && t.open.tNs >= fromNs && t.open.tNs <= toNs) out.points.push_back(t.open);
+        return out;
+    }
+
+    template<class F> static void forEach(const Slice& s, F f) {
+        for (const Raw& r : s.raw) f(point(r));
+        for (const StorePoint& p : s.points) f(p);
+    }
+
+    // Merges adjacent points so that at most maxPoints remain
+    static std::vector<StorePoint> downsample(const Slice& s, size_t maxPoints) {
+        const size_t count = s.raw.size() + s.points.size();
+        const size_t group = maxPoints ? std::max<size_t>(1, (count + maxPoints - 1) / maxPoints) : 1;
+        std::vector<StorePoint> out;
+        out.reserve((count + group - 1) / group);
+        size_t inGroup = 0;
+        forEach(s, [&](const StorePoint& p) {
+            if (inGroup++ % group == 0) out.push_back(p);
+            else out.back().merge(p);
+        });
+        return out;
+    }
+
+    // Single-threaded convenience: points within [fromNs, toNs], at most maxPoints
+    std::vector<StorePoint> range(uint64_t fromNs, uint64_t toNs, size_t maxPoints) const {
+        return downsample(slice(tierFor(fromNs), fromNs, toNs), maxPoints);
+    }
+
+private:
+    struct Tier {
+        Tier(uint64_t w, size_t capacity) : widthNs(w), ring(capacity) {}
+        uint64_t widthNs;
+        FixedRing<StorePoint> ring;
+        StorePoint open;
+        // Folds p into the open bucket. When p belongs to a later bucket the open one
+        // is closed, stored, and handed back through `closed` (true is returned).
+        bool add(const StorePoint& p, StorePoint& closed) {
+            const uint64_t bucket = p.tNs - p.tNs % widthNs;
+            bool flushed = false;
+            StorePoint in = p;
+            if (open.n && bucket != open.tNs) { ring.push(open); closed = open; flushed = true; open.n = 0; }
+            if (!open.n) { open = in; open.tNs = bucket; }
+            else open.merge(in);
+            return flushed;
+        }
+    };
+
+    static float stall(double v) { return v < 0 ? std::nanf("") : float(v); }
+    static StorePoint point(const Raw& r) {
+        StorePoint p; p.tNs = r.tNs; p.n = 1; p.min = p.max = p.avg = r.v;
+        for (int m = 0; m < kSysMetrics; ++m) p.valid[m] = !std::isnan(r.v[m]);
+        return p;
+    }
+    // Rings are in time order: binary search for the start, then copy the run
+    template<class T> static void copyRange(const FixedRing<T>& ring, uint64_t fromNs, uint64_t toNs,
+                                            std::vector<T>& out) {
+        size_t lo = 0, hi = ring.size();
+        while (lo < hi) { const size_t mid = (lo + hi) / 2; if (ring.at(mid).tNs < fromNs) lo = mid + 1; else hi = mid; }
+        size_t end = lo;
+        while (end < ring.size() && ring.at(end).tNs <= toNs) ++end;
+        out.reserve(end - lo);
+        for (size_t i = lo; i < end; ++i) out.push_back(ring.at(i));
+    }
+    size_t tierSize(int tier) const { return tier == 0 ? m_raw.size() : m_tiers[size_t(tier - 1)].ring.size(); }
+    uint64_t oldest(int tier) const {
+        if (tier == 0) return m_raw.size() ? m_raw.at(0).tNs : UINT64_MAX;
+        const Tier& t = m_tiers[size_t(tier - 1)];
+        return t.ring.size() ? t.ring.at(0).tNs : t.open.n ? t.open.tNs : UINT64_MAX;
+    }
+
+    FixedRing<Raw> m_raw;
+    std::array<Tier, kTiers - 1> m_tiers;
+    uint64_t m_firstNs = 0;
+};
+
+// Every sample goes into the history store on the sampler thread itself, so
+// the store is complete even when the UI falls behind and the ring drops.
+// Readers hold the store's lock only to copy a slice; the sampler never waits
+// for them: while one holds it, new samples queue in a backlog.
+class SamplerThread {
+public:
+    static constexpr int kMaxHz = kMaxSampleHz;
+    explicit SamplerThread(int hz) { setRateHz(hz); m_backlog.reserve(kBacklog); }
+    ~SamplerThread() { stop(); }
+
+    // Takes effect immediately: the next sample is due one new period from now
+    void setRateHz(int hz) {
+        m_periodNs = 1000000000ull / uint64_t(std::clamp(hz, 1, kMaxHz));
+        { std::lock_guard<std::mutex> lk(m_mx); m_resync = true; }
+        m_cv.notify_all();
+    }
+    int rateHz() const { return int(1000000000ull / m_periodNs.load()); }
+
+    void start() {
+        if (m_thread.joinable()) return;
+        m_stop = false;
+        m_thread = std::thread([this]{ run(); });
+    }
+    void stop() {
+        { std::lock_guard<std::mutex> lk(m_mx); m_stop = true; }
+        m_cv.notify_all();
+        if (m_thread.joinable()) m_thread.join();
+    }
+    bool pop(SysSample& s) { return m_ring.pop(s); }
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    std::vector<StorePoint> historyRange(uint64_t fromNs, uint64_t toNs, size_t maxPoints) const {
+        TimeSeriesStore::Slice s;
+        {
+            std::lock_guard<std::mutex> lk(m_historyMx);
+            s = m_history.slice(m_history.tierFor(fromNs), fromNs, toNs);
+        }
+        return TimeSeriesStore::downsample(s, maxPoints);
+    }
+    TimeSeriesStore::Slice historyTier(int tier) const {
+        std::lock_guard<std::mutex> lk(m_historyMx);
+        return m_history.slice(tier, 0, UINT64_MAX);
+    }
+
+private:
+    void run() {
+        // Real-time priority needs CAP_SYS_NICE; otherwise ask for a better nice value.
+        // Neither is required, the thread just competes with the stressors normally.
+        sched_param sp{}; sp.sched_priority = 1;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) != 0)
+            setpriority(PRIO_PROCESS, pid_t(syscall(SYS_gettid)), -10);
+        pthread_setname_np(pthread_self(), "hst-sampler");
+
+        // Absolute deadlines on the monotonic clock: late wake-ups do not accumulate
+        uint64_t next = monoNs(), diskNs = 0;
+        double disk = 0, diskUsed = 0, diskTotal = 0;
+        std::unique_lock<std::mutex> lk(m_mx);
+        while (!m_stop) {
+            if (m_resync) { m_resync = false; next = monoNs(); }
+            lk.unlock();
+            SysSample s;
+            s.tNs = monoNs();
+            if (m_cpu.sample(m_stat)) {
+                s.cpu = m_cpu.total();
+                s.cores = uint16_t(m_cpu.cores());
+                for (int c = 0; c < s.cores; ++c) s.core[size_t(c)] = uint8_t(std::lround(m_cpu.core(c)));
+            }
+            s.mem  = memPercent(m_meminfo, &s.memUsedGiB, &s.memTotalGiB);
+            s.cpuStall = m_psiCpu.sample(s.tNs);
+            s.ioStall  = m_psiIo.sample(s.tNs);
+            s.memStall = m_psiMem.sample(s.tNs);
+            // Filesystem usage moves slowly; statvfs once a second is plenty at any rate
+            if (s.tNs - diskNs >= 1000000000ull) {
+                disk = rootDiskPercent(&diskUsed, &diskTotal);
+                diskNs = s.tNs;
+            }
+            s.disk = disk; s.diskUsedGiB = diskUsed; s.diskTotalGiB = diskTotal;
+            if (std::unique_lock<std::mutex> hl(m_historyMx, std::try_to_lock); !hl && m_backlog.size() < kBacklog) {
+                m_backlog.push_back(s);
+            } else {
+                if (!hl) hl.lock();   // a reader has held it for a second's worth of samples: wait rather than lose them
+                for (const auto& b : m_backlog) m_history.add(b);
+                m_backlog.clear();
+                m_history.add(s);
+            }
+            if (!m_ring.push(s)) m_dropped.fetch_add(1, std::memory_order_relaxed);
+            next += m_periodNs.load(std::memory_order_relaxed);
+            const uint64_t now = monoNs();
+            if (next < now) next = now;   // fell behind (suspend, stall): skip, don't burst
+            lk.lock();
+            m_cv.wait_until(lk, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(next)),
+                            [this]{ return m_stop || m_resync; });
+        }
+    }
+
+    std::atomic<uint64_t> m_periodNs{1000000000ull};
+    ProcStat m_stat{"/proc/stat"};
+    CpuMeter m_cpu;
+    ProcMeminfo m_meminfo{"/proc/meminfo"};
+    PsiMeter m_psiCpu{"/proc/pressure/cpu"}, m_psiIo{"/proc/pressure/io"}, m_psiMem{"/proc/pressure/memory"};
+    SpscRing<SysSample, 2048> m_ring;   // > one UI refresh worth of samples at kMaxHz
+    std::atomic<uint64_t> m_dropped{0};
+    TimeSeriesStore m_history;
+    mutable std::mutex m_historyMx;
+    static constexpr size_t kBacklog = kMaxHz;
+    std::vector<SysSample> m_backlog;   // sampler thread only; reserved up front
+    std::thread m_thread;
+    std::mutex m_mx;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+    bool m_resync = false;
+};
+
+// -----------------------------
+// Headless engines (hst --engine <name> [--key value ...])
+// Native workloads run in a child copy of this binary, so they reuse the
+// QProcess plumbing (live output, log file, Stop) of the external tools.
+// -----------------------------
+
+static std::atomic<bool> g_engineStop{false};
+
+static uint64_t parseBytes(const std::string& s, uint64_t def) {
+    if (s.empty()) return def;
+    char* end = nullptr;
+    double v = std::strtod(s.c_str(), &end);
+    if (end == s.c_str() || v < 0) return def;
+    switch (std::tolower((unsigned char)*end)) {
+        case 'k': v *= 1024.0; break;
+        case 'm': v *= 1024.0*1024; break;
+        case 'g': v *= 1024.0*1024*1024; break;
+        case 't': v *= 1024.0*1024*1024*1024; break;
+        default: break;
+    }
+    return uint64_t(v);
+}
+
+struct EngineArgs {
+    std::map<std::string,std::string> kv;
+    std::vector<char*> rest;     // everything after a bare "--"
+
+    EngineArgs(int argc, char** argv) {
+        for (int i = 0; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--") == 0) { rest.assign(argv + i + 1, argv + argc); break; }
+            if (std::strncmp(argv[i], "--", 2) != 0) continue;
+            std::string k = argv[i] + 2;
+            if (i+1 < argc && std::strncmp(argv[i+1], "--", 2) != 0) kv[k] = argv[++i];
+            else kv[k] = "1";
+        }
+    }
+    std::string str(const char* k, const std::string& def="") const {
+        auto it = kv.find(k); return it == kv.end() ? def : it->second;
+    }
+    long num(const char* k, long def) const {
+        auto it = kv.find(k); return it == kv.end() ? def : std::strtol(it->second.c_str(), nullptr, 10);
+    }
+    bool flag(const char* k, bool def=false) const {
+        auto it = kv.find(k);
+        if (it == kv.end()) return def;
+        return it->second == "1" || it->second == "true" || it->second == "yes";
+    }
+    uint64_t bytes(const char* k, uint64_t def) const { return parseBytes(str(k), def); }
+};
+
+// --- Latency histogram ---
+// Log-linear (HDR-style): values below 2^kSubBits are exact; each higher power
+// of two is split into 2^kSubBits linear sub-buckets, so the relative error is
+// under 1% at any magnitude. Fixed memory, O(1) record, mergeable per thread.
+
+class LatencyHistogram {
+public:
+    static constexpr int kSubBits = 7;
+    static constexpr size_t kBuckets = size_t(65 - kSubBits) << kSubBits;
+
+    void record(uint64_t v) {
+        ++m_counts[index(v)];
+        ++m_total;
+        m_sum += v;
+        m_min = std::min(m_min, v);
+        m_max = std::max(m_max, v);
+    }
+    void merge(const LatencyHistogram& o) {
+        for (size_t i = 0; i < kBuckets; ++i) m_counts[i] += o.m_counts[i];
+        m_total += o.m_total; m_sum += o.m_sum;
+        m_min = std::min(m_min, o.m_min); m_max = std::max(m_max, o.m_max);
+    }
+    void reset() { *this = LatencyHistogram(); }
+
+    uint64_t count() const { return m_total; }
+    uint64_t min() const { return m_total ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_total ? double(m_sum) / double(m_total) : 0.0; }
+
+    // Value at percentile p (0..100), reported as the bucket midpoint.
+    uint64_t percentile(double p) const {
+        if (!m_total) return 0;
+        uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(p / 100.0 * double(m_total))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += m_counts[i];
+            if (seen >= rank) return std::clamp(lowest(i) + width(i) / 2, min(), m_max);
+        }
+        return m_max;
+    }
+
+    // f(bucketLowestValue, bucketWidth, count) for every non-empty bucket.
+    template <class F> void forEach(F f) const {
+        for (size_t i = 0; i < kBuckets; ++i)
+            if (m_counts[i]) f(lowest(i), width(i), m_counts[i]);
+    }
+
+private:
+    static size_t index(uint64_t v) {
+        if (v < (1ull << kSubBits)) return size_t(v);
+        int msb = 63 - __builtin_clzll(v);
+        int mag = msb - kSubBits + 1;
+        return (size_t(mag) << kSubBits) | size_t((v >> (mag - 1)) & ((1ull << kSubBits) - 1));
+    }
+    static uint64_t lowest(size_t i) {
+        uint64_t mag = i >> kSubBits, sub = i & ((1ull << kSubBits) - 1);
+        return mag == 0 ? sub : ((1ull << kSubBits) | sub) << (mag - 1);
+    }
+    static uint64_t width(size_t i) {
+        uint64_t mag = i >> kSubBits;
+        return mag == 0 ? 1 : 1ull << (mag - 1);
+    }
+
+    std::array<uint64_t, kBuckets> m_counts{};
+    uint64_t m_total = 0, m_sum = 0, m_min = ~0ull, m_max = 0;
+};
+
+// Machine-readable records are single stdout lines starting with "@hst ",
+// followed by a JSON object; the GUI consumes them, the log keeps them.
+static void emitLatency(const std::string& label, const LatencyHistogram& h) {
+    std::printf("@hst {\"type\":\"lat\",\"label\":\"%s\",\"count\":%llu,\"p50\":%llu,\"p99\":%llu,"
+                "\"p999\":%llu,\"p9999\":%llu,\"max\":%llu}\n", label.c_str(),
+                (unsigned long long)h.count(), (unsigned long long)h.percentile(50),
+                (unsigned long long)h.percentile(99), (unsigned long long)h.percentile(99.9),
+                (unsigned long long)h.percentile(99.99), (unsigned long long)h.max());
+}
+
+static void emitHistogram(const std::string& label, const LatencyHistogram& h) {
+    std::printf("@hst {\"type\":\"hist\",\"label\":\"%s\",\"unit\":\"ns\",\"count\":%llu,"
+                "\"min\":%llu,\"max\":%llu,\"mean\":%.1f,\"buckets\":[", label.c_str(),
+                (unsigned long long)h.count(), (unsigned long long)h.min(), (unsigned long long)h.max(), h.mean());
+    const char* sep = "";
+    h.forEach([&](uint64_t lo, uint64_t, uint64_t n) {
+        std::printf("%s[%llu,%llu]", sep, (unsigned long long)lo, (unsigned long long)n);
+        sep = ",";
+    });
+    std::printf("]}\n");
+}
+
+// Generic end-of-run summary: @hst {"type":"result","label":...,<metrics>}.
+static void emitResult(const std::string& label, const std::vector<std::pair<const char*, double>>& kv) {
+    std::printf("@hst {\"type\":\"result\",\"label\":\"%s\"", label.c_str());
+    for (const auto& [k, v] : kv) std::printf(",\"%s\":%.10g", k, v);
+    std::printf("}\n");
+}
+
+// --- Disk I/O backends ---
+// One request per buffer slot; the driver keeps `depth` slots in flight.
+
+struct IoCompletion { unsigned slot; int res; };
+
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+    virtual std::string name() const = 0;
+    virtual unsigned maxDepth() const { return 4096; }
+    // Queue one request on buffer `slot`; nothing is issued until wait().
+    virtual void queue(unsigned slot, bool write, uint64_t offset) = 0;
+    // Submit queued requests and collect at least `minComplete` completions.
+    // Returns the number of completions, or -errno.
+    virtual int wait(unsigned minComplete, std::vector<IoCompletion>& out) = 0;
+};
+
+#ifdef __NR_io_uring_setup
+class UringBackend : public IoBackend {
+public:
+    static std::unique_ptr<IoBackend> create(int fd, const std::vector<void*>& bufs, size_t bs,
+                                             bool sqpoll, std::string& err) {
+        std::unique_ptr<UringBackend> u(new UringBackend(fd, bufs, bs));
+        if (!u->init(sqpoll, err)) return nullptr;
+        return u;
+    }
+    ~UringBackend() override {
+        if (m_sqes) munmap(m_sqes, m_sqesLen);
+        if (m_cqPtr && m_cqPtr != m_sqPtr) munmap(m_cqPtr, m_cqLen);
+        if (m_sqPtr) munmap(m_sqPtr, m_sqLen);
+        if (m_ring >= 0) close(m_ring);
+    }
+
+    std::string name() const override {
+        std::string n = "io_uring";
+        if (m_fixedBufs) n += " +regbufs";
+        if (m_fixedFile) n += " +regfile";
+        if (m_sqpoll) n += " +sqpoll";
+        return n;
+    }
+
+    void queue(unsigned slot, bool write, uint64_t offset) override {
+        unsigned tail = *m_sqTail;
+        unsigned idx = tail & *m_sqMask;
+        io_uring_sqe* sqe = &m_sqes[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        if (m_fixedBufs) {
+            sqe->opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            sqe->addr = uint64_t(uintptr_t(m_bufs[slot]));
+            sqe->len = unsigned(m_bs);
+            sqe->buf_index = uint16_t(slot);
+        } else {
+            sqe->opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe->addr = uint64_t(uintptr_t(&m_iovs[slot]));
+            sqe->len = 1;
+        }
+        sqe->fd = m_fixedFile ? 0 : m_fd;
+        if (m_fixedFile) sqe->flags |= IOSQE_FIXED_FILE;
+        sqe->off = offset;
+        sqe->user_data = slot;
+        m_sqArray[idx] = idx;
+        __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++m_pending;
+    }
+
+    int wait(unsigned minComplete, std::vector<IoCompletion>& out) override {
+        out.clear();
+        reap(out);
+        if (out.size() >= minComplete && m_pending == 0) return int(out.size());
+
+        unsigned flags = 0, submit = m_pending;
+        if (m_sqpoll) {
+            submit = 0; // the kernel thread consumes the SQ on its own
+            if (__atomic_load_n(m_sqFlags, __ATOMIC_ACQUIRE) & IORING_SQ_NEED_WAKEUP)
+                flags |= IORING_ENTER_SQ_WAKEUP;
+        }
+        unsigned need = out.size() >= minComplete ? 0 : minComplete - unsigned(out.size());
+        if (need) flags |= IORING_ENTER_GETEVENTS;
+        if (submit || flags) {
+            long r = syscall(__NR_io_uring_enter, m_ring, submit, need, flags, nullptr, 0);
+            if (r < 0) {
+                if (errno != EINTR && errno != EAGAIN && errno != EBUSY) return -errno;
+            } else if (!m_sqpoll) {
+                m_pending -= std::min<unsigned>(m_pending, unsigned(r));
+            }
+        }
+        if (m_sqpoll) m_pending = 0;
+        reap(out);
+        return int(out.size());
+    }
+
+private:
+    UringBackend(int fd, const std::vector<void*>& bufs, size_t bs) : m_fd(fd), m_bufs(bufs), m_bs(bs) {
+        for (void* b : bufs) m_iovs.push_back({b, bs});
+    }
+
+    bool init(bool sqpoll, std::string& err) {
+        unsigned entries = 1;
+        while (entries < m_bufs.size()) entries <<= 1;
+        io_uring_params p{};
+        if (sqpoll) { p.flags |= IORING_SETUP_SQPOLL; p.sq_thread_idle = 2000; }
+        m_ring = int(syscall(__NR_io_uring_setup, entries, &p));
+        if (m_ring < 0 && sqpoll) {
+            // SQPOLL needs CAP_SYS_NICE before 5.11; run without it.
+            std::printf("note: SQPOLL unavailable (%s), using plain submission\n", std::strerror(errno));
+            p = io_uring_params{};
+            m_ring = int(syscall(__NR_io_uring_setup, entries, &p));
+        }
+        if (m_ring < 0) { err = std::string("io_uring_setup: ") + std::strerror(errno); return false; }
+        m_sqpoll = (p.flags & IORING_SETUP_SQPOLL) != 0;
+
+        m_sqLen = p.sq_off.array + p.sq_entries*sizeof(unsigned);
+        m_cqLen = p.cq_off.cqes + p.cq_entries*sizeof(io_uring_cqe);
+        bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) m_sqLen = m_cqLen = std::max(m_sqLen, m_cqLen);
+        m_sqPtr = mmap(nullptr, m_sqLen, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, m_ring, IORING_OFF_SQ_RING);
+        if (m_sqPtr == MAP_FAILED) { m_sqPtr = nullptr; err = "io_uring: cannot map SQ ring"; return false; }
+        m_cqPtr = single ? m_sqPtr
+                         : mmap(nullptr, m_cqLen, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, m_ring, IORING_OFF_CQ_RING);
+        if (m_cqPtr == MAP_FAILED) { m_cqPtr = nullptr; err = "io_uring: cannot map CQ ring"; return false; }
+        m_sqesLen = p.sq_entries*sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, m_sqesLen, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, m_ring, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) { err = "io_uring: cannot map SQEs"; return false; }
+        m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<char*>(m_sqPtr);
+        auto* cq = static_cast<char*>(m_cqPtr);
+        m_sqTail  = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        m_sqMask  = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        m_sqFlags = reinterpret_cast<unsigned*>(sq + p.sq_off.flags);
+        m_sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        m_cqHead  = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        m_cqTail  = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        m_cqMask  = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        m_cqes    = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+        // Registered buffers are pinned memory and count against RLIMIT_MEMLOCK.
+        m_fixedBufs = syscall(__NR_io_uring_register, m_ring, IORING_REGISTER_BUFFERS,
+                              m_iovs.data(), unsigned(m_iovs.size())) == 0;
+        if (!m_fixedBufs)
+            std::printf("note: buffer registration failed (%s), using readv/writev\n", std::strerror(errno));
+        m_fixedFile = syscall(__NR_io_uring_register, m_ring, IORING_REGISTER_FILES, &m_fd, 1) == 0;
+        return true;
+    }
+
+    void reap(std::vector<IoCompletion>& out) {
+        unsigned head = *m_cqHead;
+        unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail) {
+            const io_uring_cqe& c = m_cqes[head & *m_cqMask];
+            out.push_back({unsigned(c.user_data), c.res});
+            ++head;
+        }
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    int m_fd;
+    std::vector<void*> m_bufs;
+    std::vector<iovec> m_iovs;
+    size_t m_bs;
+    int m_ring = -1;
+    bool m_sqpoll = false, m_fixedBufs = false, m_fixedFile = false;
+    void *m_sqPtr = nullptr, *m_cqPtr = nullptr;
+    size_t m_sqLen = 0, m_cqLen = 0, m_sqesLen = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    unsigned *m_sqTail = nullptr, *m_sqMask = nullptr, *m_sqFlags = nullptr, *m_sqArray = nullptr;
+    unsigned *m_cqHead = nullptr, *m_cqTail = nullptr, *m_cqMask = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+    unsigned m_pending = 0;
+};
+#endif
+
+// Linux native AIO through the raw syscalls (no libaio link dependency).
+class AioBackend : public IoBackend {
+public:
+    static std::unique_ptr<IoBackend> create(int fd, const std::vector<void*>& bufs, size_t bs, std::string& err) {
+        std::unique_ptr<AioBackend> a(new AioBackend(fd, bufs, bs));
+        if (syscall(__NR_io_setup, unsigned(bufs.size()), &a->m_ctx) != 0) {
+            err = std::string("io_setup: ") + std::strerror(errno);
+            return nullptr;
+        }
+        return a;
+    }
+    ~AioBackend() override { if (m_ctx) syscall(__NR_io_destroy, m_ctx); }
+
+    std::string name() const override { return "libaio"; }
+
+    void queue(unsigned slot, bool write, uint64_t offset) override {
+        iocb& cb = m_cbs[slot];
+        std::memset(&cb, 0, sizeof(cb));
+        cb.aio_fildes = uint32_t(m_fd);
+        cb.aio_lio_opcode = write ? IOCB_CMD_PWRITE : IOCB_CMD_PREAD;
+        cb.aio_buf = uint64_t(uintptr_t(m_bufs[slot]));
+        cb.aio_nbytes = m_bs;
+        cb.aio_offset = int64_t(offset);
+        cb.aio_data = slot;
+        m_queued.push_back(&cb);
+    }
+
+    int wait(unsigned minComplete, std::vector<IoCompletion>& out) override {
+        out.clear();
+        while (!m_queued.empty()) {
+            long r = syscall(__NR_io_submit, m_ctx, long(m_queued.size()), m_queued.data());
+            if (r < 0) {
+                if (errno == EINTR || errno == EAGAIN) break;
+                return -errno;
+            }
+            m_queued.erase(m_queued.begin(), m_queued.begin() + r);
+        }
+        long n = syscall(__NR_io_getevents, m_ctx, long(minComplete), long(m_events.size()), m_events.data(), nullptr);
+        if (n < 0) return errno == EINTR ? 0 : -errno;
+        for (long i = 0; i < n; ++i) out.push_back({unsigned(m_events[i].data), int(m_events[i].res)});
+        return int(n);
+    }
+
+private:
+    AioBackend(int fd, const std::vector<void*>& bufs, size_t bs)
+        : m_fd(fd), m_bufs(bufs), m_bs(bs), m_cbs(bufs.size()), m_events(bufs.size()) {}
+
+    int m_fd;
+    std::vector<void*> m_bufs;
+    size_t m_bs;
+    aio_context_t m_ctx = 0;
+    std::vector<iocb> m_cbs;
+    std::vector<iocb*> m_queued;
+    std::vector<io_event> m_events;
+};
+
+// Synchronous pread/pwrite: the last resort, and inherently queue depth 1.
+class PsyncBackend : public IoBackend {
+public:
+    PsyncBackend(int fd, const std::vector<void*>& bufs, size_t bs) : m_fd(fd), m_bufs(bufs), m_bs(bs) {}
+    std::string name() const override { return "psync"; }
+    unsigned maxDepth() const override { return 1; }
+
+    void queue(unsigned slot, bool write, uint64_t offset) override { m_queued.push_back({slot, write, offset}); }
+
+    int wait(unsigned, std::vector<IoCompletion>& out) override {
+        out.clear();
+        for (const auto& q : m_queued) {
+            ssize_t r = q.write ? pwrite(m_fd, m_bufs[q.slot], m_bs, off_t(q.offset))
+                                : pread (m_fd, m_bufs[q.slot], m_bs, off_t(q.offset));
+            out.push_back({q.slot, r < 0 ? -errno : int(r)});
+        }
+        m_queued.clear();
+        return int(out.size());
+    }
+
+private:
+    struct Req { unsigned slot; bool write; uint64_t offset; };
+    int m_fd;
+    std::vector<void*> m_bufs;
+    size_t m_bs;
+    std::vector<Req> m_queued;
+};
+
+// engine: "auto" tries io_uring, then libaio, then psync.
+static std::unique_ptr<IoBackend> makeIoBackend(const std::string& engine, int fd, const std::vector<void*>& bufs,
+                                                size_t bs, bool sqpoll) {
+    std::string err;
+#ifdef __NR_io_uring_setup
+    if (engine == "auto" || engine == "io_uring") {
+        if (auto b = UringBackend::create(fd, bufs, bs, sqpoll, err)) return b;
+        std::printf("note: %s, falling back\n", err.c_str());
+    }
+#endif
+    if (engine == "auto" || engine == "io_uring" || engine == "libaio") {
+        if (auto b = AioBackend::create(fd, bufs, bs, err)) return b;
+        std::printf("note: %s, falling back\n", err.c_str());
+    }
+    return std::make_unique<PsyncBackend>(fd, bufs, bs);
+}
+
+// --- Disk target ---
+
+struct DiskTarget {
+    int fd = -1;
+    uint64_t size = 0;
+    bool blockDev = false;
+    ~DiskTarget() { if (fd >= 0) close(fd); }
+};
+
+// --- Prepared test-file cache ---
+// Test files are preallocated, filled with random data in parallel and then
+// listed in a manifest under the HST data directory. A later run that asks for
+// the same file (same inode and filesystem, at least the same size) starts
+// immediately instead of laying it out again.
+
+static std::string hstDataDir() {
+    const char* home = std::getenv("HOME");
+    std::string d = std::string(home ? home : "/tmp") + "/HardwareStressTest";
+    mkdir(d.c_str(), 0755);
+    return d;
+}
+
+static std::string fsTypeName(const std::string& path) {
+    struct statfs sf{};
+    if (statfs(path.c_str(), &sf) != 0) return "unknown";
+    switch (uint64_t(sf.f_type)) {
+        case 0xEF53:     return "ext4";
+        case 0x58465342: return "xfs";
+        case 0x9123683E: return "btrfs";
+        case 0xF2F52010: return "f2fs";
+        case 0x2FC12FC1: return "zfs";
+        case 0x01021994: return "tmpfs";
+        case 0x794C7630: return "overlay";
+        case 0x6969:     return "nfs";
+        default: break;
+    }
+    char hex[24];
+    std::snprintf(hex, sizeof hex, "0x%llx", (unsigned long long)sf.f_type);
+    return hex;
+}
+
+struct PreparedFile {
+    std::string path, fs, pattern;
+    uint64_t size = 0, dev = 0, ino = 0;
+    long long prepared = 0;
+};
+
+// Manifest: one tab-separated line per file, guarded by flock().
+class TestFileManifest {
+public:
+    TestFileManifest() : m_path(hstDataDir() + "/testfile-manifest.tsv") {
+        m_fd = open(m_path.c_str(), O_RDWR|O_CREAT, 0644);
+        if (m_fd >= 0) flock(m_fd, LOCK_EX);
+        load();
+    }
+    ~TestFileManifest() { if (m_fd >= 0) { flock(m_fd, LOCK_UN); close(m_fd); } }
+
+    const PreparedFile* find(const std::string& path) const {
+        for (const auto& e : m_entries) if (e.path == path) return &e;
+        return nullptr;
+    }
+    void put(const PreparedFile& f) {
+        drop(f.path);
+        m_entries.push_back(f);
+        save();
+    }
+    void drop(const std::string& path) {
+        m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(),
+                                       [&](const PreparedFile& e){ return e.path == path; }), m_entries.end());
+        save();
+    }
+
+private:
+    void load() {
+        if (m_fd < 0) return;
+        std::string text;
+        char buf[4096];
+        for (ssize_t n; (n = pread(m_fd, buf, sizeof buf, off_t(text.size()))) > 0; ) text.append(buf, size_t(n));
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t nl = text.find('\n', pos);
+            if (nl == std::string::npos) nl = text.size();
+            std::vector<std::string> f;
+            for (size_t a = pos; a <= nl; ) {
+                size_t tab = std::min(text.find('\t', a), nl);
+                f.push_back(text.substr(a, tab - a));
+                a = tab + 1;
+            }
+            if (f.size() == 7) {
+                PreparedFile e;
+                e.path = f[0]; e.size = std::strtoull(f[1].c_str(), nullptr, 10); e.fs = f[2];
+                e.dev = std::strtoull(f[3].c_str(), nullptr, 10); e.ino = std::strtoull(f[4].c_str(), nullptr, 10);
+                e.pattern = f[5]; e.prepared = std::strtoll(f[6].c_str(), nullptr, 10);
+                m_entries.push_back(e);
+            }
+            pos = nl + 1;
+        }
+    }
+    void save() {
+        if (m_fd < 0) return;
+        std::string text;
+        for (const auto& e : m_entries) {
+            char line[PATH_MAX + 160];
+            std::snprintf(line, sizeof line, "%s\t%llu\t%s\t%llu\t%llu\t%s\t%lld\n", e.path.c_str(),
+                          (unsigned long long)e.size, e.fs.c_str(), (unsigned long long)e.dev,
+                          (unsigned long long)e.ino, e.pattern.c_str(), e.prepared);
+            text += line;
+        }
+        if (ftruncate(m_fd, 0) == 0 && pwrite(m_fd, text.data(), text.size(), 0) == ssize_t(text.size()))
+            fdatasync(m_fd);
+    }
+
+    std::string m_path;
+    int m_fd = -1;
+    std::vector<PreparedFile> m_entries;
+};
+
+// For workloads that overwrite the file with something other than its pattern.
+static void forgetPreparedFile(const std::string& path) {
+    char resolved[PATH_MAX];
+    TestFileManifest().drop(realpath(path.c_str(), resolved) ? resolved : path);
+}
+
+// Make `path` a fully allocated regular file of at least `size` bytes of random
+// data, reusing a previously prepared one when the manifest says it is intact.
+static bool prepareTestFile(const std::string& path, uint64_t size, bool reuse, std::string& err) {
+    static const char* kPattern = "random";
+    char resolved[PATH_MAX];
+    int fd = open(path.c_str(), O_WRONLY|O_CREAT, 0644);
+    if (fd < 0) { err = path + ": " + std::strerror(errno); return false; }
+    const std::string key = realpath(path.c_str(), resolved) ? resolved : path;
+    struct stat st{};
+    fstat(fd, &st);
+    const std::string fs = fsTypeName(key);
+
+    TestFileManifest manifest;
+    const PreparedFile* known = manifest.find(key);
+    if (reuse && known && known->dev == uint64_t(st.st_dev) && known->ino == uint64_t(st.st_ino) &&
+        known->fs == fs && known->pattern == kPattern && known->size >= size && uint64_t(st.st_size) >= size) {
+        std::printf("reusing prepared test file %s (%llu MiB, %s, prepared %lld s ago)\n", key.c_str(),
+                    (unsigned long long)(known->size >> 20), fs.c_str(), (long long)std::time(nullptr) - known->prepared);
+        close(fd);
+        return true;
+    }
+
+    std::printf("preparing %s (%llu MiB on %s)...\n", key.c_str(), (unsigned long long)(size >> 20), fs.c_str());
+    const uint64_t t0 = monoNs();
+    if (uint64_t(st.st_size) > size && ftruncate(fd, off_t(size)) != 0) {
+        err = path + ": ftruncate: " + std::strerror(errno); close(fd); return false;
+    }
+    if (fallocate(fd, 0, 0, off_t(size)) != 0 && errno != EOPNOTSUPP)
+        std::printf("note: fallocate: %s\n", std::strerror(errno));
+
+    // Parallel fill: each thread owns an interleaved set of 4 MiB chunks.
+    const uint64_t chunk = 4ull << 20, chunks = (size + chunk - 1) / chunk;
+    const unsigned threads = unsigned(std::clamp<uint64_t>(chunks, 1, std::min(8u, std::max(1u, std::thread::hardware_concurrency()))));
+    std::atomic<uint64_t> written{0};
+    std::atomic<int> writeErr{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::vector<uint64_t> buf(chunk / 8);
+            std::mt19937_64 rng(monoNs() + t);
+            for (uint64_t c = t; c < chunks && !g_engineStop && !writeErr; c += threads) {
+                for (auto& w : buf) w = rng();
+                const uint64_t off = c * chunk, n = std::min(chunk, size - off);
+                if (pwrite(fd, buf.data(), size_t(n), off_t(off)) != ssize_t(n)) { writeErr = errno ? errno : EIO; break; }
+                written += n;
+            }
+        });
+    }
+    uint64_t nextNote = monoNs() + 2000000000ull;
+    for (auto& th : pool) {
+        while (th.joinable()) {
+            if (written >= size || writeErr || g_engineStop) { th.join(); break; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (monoNs() >= nextNote) {
+                std::printf("  prepared %.0f%%\n", 100.0 * double(written) / double(size));
+                nextNote += 2000000000ull;
+            }
+        }
+    }
+    if (writeErr) { err = path + ": write: " + std::strerror(writeErr); close(fd); manifest.drop(key); return false; }
+    if (g_engineStop) { close(fd); return false; }
+    fsync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);   // start the workload with a cold cache
+    fstat(fd, &st);
+    close(fd);
+    std::printf("prepared in %.1f s\n", (monoNs() - t0) / 1e9);
+
+    PreparedFile e;
+    e.path = key; e.size = size; e.fs = fs; e.pattern = kPattern;
+    e.dev = uint64_t(st.st_dev); e.ino = uint64_t(st.st_ino); e.prepared = (long long)std::time(nullptr);
+    manifest.put(e);
+    return true;
+}
+
+// --- Block device discovery ---
+
+struct BlockDevice {
+    std::string name, path, model, scheduler;
+    std::string parent;          // whole disk, for partitions
+    uint64_t size = 0;
+    unsigned queueDepth = 0;     // nr_requests
+    bool rotational = false, loop = false, readOnly = false, mounted = false;
+    bool held = false;           // claimed by LVM, device mapper or md RAID
+};
+
+static std::string readSysfs(const std::string& path) {
+    std::ifstream f(path);
+    std::string s;
+    std::getline(f, s);
+    while (!s.empty() && std::isspace((unsigned char)s.back())) s.pop_back();
+    return s;
+}
+
+// "maj:min" of every mounted block device, from mountinfo field 3.
+static std::vector<std::string> mountedDevNumbers() {
+    std::vector<std::string> out;
+    std::ifstream f("/proc/self/mountinfo");
+    std::string id, parent, devno, line;
+    while (f >> id >> parent >> devno) {
+        out.push_back(devno);
+        std::getline(f, line);
+    }
+    return out;
+}
+
+// First entry of a device's holders/ directory (the dm-N or mdN built on
+// top of it), or "" when nothing claims the device.
+static std::string blockHolder(const std::filesystem::path& sys) {
+    std::error_code ec;
+    for (const auto& e : std::filesystem::directory_iterator(sys / "holders", ec)) return e.path().filename().string();
+    return "";
+}
+
+// Disks and their partitions from /sys/block. Empty devices (unbound loop
+// devices, drives without media) and ramdisks are skipped.
+static std::vector<BlockDevice> listBlockDevices() {
+    namespace fs = std::filesystem;
+    std::vector<BlockDevice> out;
+    const auto mounted = mountedDevNumbers();
+    auto isMounted = [&](const fs::path& sys) {
+        return std::find(mounted.begin(), mounted.end(), readSysfs((sys / "dev").string())) != mounted.end();
+    };
+    std::error_code ec;
+    std::vector<fs::path> disks;
+    for (const auto& e : fs::directory_iterator("/sys/block", ec)) disks.push_back(e.path());
+    std::sort(disks.begin(), disks.end());
+    for (const auto& sys : disks) {
+        BlockDevice d;
+        d.name = sys.filename().string();
+        if (d.name.rfind("ram", 0) == 0) continue;
+        d.path = "/dev/" + d.name;
+        d.size = std::strtoull(readSysfs((sys / "size").string()).c_str(), nullptr, 10) * 512;
+        if (d.size == 0) continue;
+        d.rotational = readSysfs((sys / "queue/rotational").string()) == "1";
+        d.queueDepth = unsigned(std::strtoul(readSysfs((sys / "queue/nr_requests").string()).c_str(), nullptr, 10));
+        d.scheduler = readSysfs((sys / "queue/scheduler").string());
+        if (auto l = d.scheduler.find('['), r = d.scheduler.find(']'); l != std::string::npos && r > l)
+            d.scheduler = d.scheduler.substr(l + 1, r - l - 1);
+        d.readOnly = readSysfs((sys / "ro").string()) == "1";
+        d.loop = fs::exists(sys / "loop");
+        d.model = d.loop ? readSysfs((sys / "loop/backing_file").string()) : readSysfs((sys / "device/model").string());
+        d.mounted = isMounted(sys);
+        d.held = !blockHolder(sys).empty();
+        std::vector<fs::path> parts;
+        for (const auto& e : fs::directory_iterator(sys, ec))
+            if (fs::exists(e.path() / "partition")) parts.push_back(e.path());
+        std::sort(parts.begin(), parts.end());
+        out.push_back(d);
+        for (const auto& ps : parts) {
+            BlockDevice p = d;
+            p.parent = d.name;
+            p.name = ps.filename().string();
+            p.path = "/dev/" + p.name;
+            p.size = std::strtoull(readSysfs((ps / "size").string()).c_str(), nullptr, 10) * 512;
+            p.readOnly = d.readOnly || readSysfs((ps / "ro").string()) == "1";
+            p.mounted = isMounted(ps);
+            p.held = !blockHolder(ps).empty();
+            if (p.mounted) out.back().mounted = true;   // writing the disk would hit the mounted partition
+            if (p.held) out.back().held = true;
+            out.push_back(p);
+        }
+    }
+    return out;
+}
+
+// Raw block devices are only written with --raw-write. Loop devices are
+// backed by a file and meant for this, so they are writable unless in use.
+// In use means the device or one of its partitions is mounted, or is claimed
+// by a holder (LVM, device mapper, md RAID).
+static bool checkBlockWrite(const std::string& path, bool rawWrite, std::string& err) {
+    namespace fs = std::filesystem;
+    struct stat st{};
+    if (stat(path.c_str(), &st) != 0 || !S_ISBLK(st.st_mode)) return true;
+    const std::string devno = std::to_string(major(st.st_rdev)) + ":" + std::to_string(minor(st.st_rdev));
+    const auto mounted = mountedDevNumbers();
+    std::error_code ec;
+    const fs::path sys = fs::canonical("/sys/dev/block/" + devno, ec);
+    std::vector<fs::path> nodes{sys};
+    if (!ec)
+        for (const auto& e : fs::directory_iterator(sys, ec))
+            if (fs::exists(e.path() / "partition")) nodes.push_back(e.path());
+    for (const auto& n : nodes) {
+        const std::string name = n.empty() ? path : "/dev/" + n.filename().string();
+        const std::string dev = n.empty() ? devno : readSysfs((n / "dev").string());
+        if (std::find(mounted.begin(), mounted.end(), dev) != mounted.end()) {
+            err = name + " is mounted; refusing to write to " + path;
+            return false;
+        }
+        if (const std::string holder = n.empty() ? "" : blockHolder(n); !holder.empty()) {
+            err = name + " is in use by " + holder + "; refusing to write to " + path;
+            return false;
+        }
+    }
+    if (major(st.st_rdev) != 7 && !rawWrite) {   // 7 = loop
+        err = path + " is a block device; this workload writes to it (pass --raw-write 1)";
+        return false;
+    }
+    return true;
+}
+
+// hst --engine devices
+// Lists block devices and partitions, one "device" record each.
+static int engineDevices(const EngineArgs&) {
+    const auto devs = listBlockDevices();
+    std::printf("%-14s %10s %5s %6s %-12s %s\n", "device", "size", "type", "QD", "scheduler", "model");
+    for (const auto& d : devs) {
+        const char* type = d.loop ? "loop" : d.rotational ? "hdd" : "ssd";
+        std::printf("%-14s %9.1fG %5s %6u %-12s %s%s%s%s\n", d.name.c_str(), d.size / 1073741824.0, type, d.queueDepth,
+                    d.scheduler.c_str(), d.model.c_str(), d.mounted ? " (mounted)" : "", d.held ? " (in use)" : "",
+                    d.readOnly ? " (ro)" : "");
+        std::printf("@hst {\"type\":\"device\",\"name\":\"%s\",\"path\":\"%s\",\"parent\":\"%s\",\"size\":%llu,"
+                    "\"rotational\":%s,\"loop\":%s,\"queue_depth\":%u,\"scheduler\":\"%s\",\"mounted\":%s,"
+                    "\"held\":%s,\"ro\":%s}\n",
+                    d.name.c_str(), d.path.c_str(), d.parent.c_str(), (unsigned long long)d.size,
+                    d.rotational ? "true" : "false", d.loop ? "true" : "false", d.queueDepth, d.scheduler.c_str(),
+                    d.mounted ? "true" : "false", d.held ? "true" : "false", d.readOnly ? "true" : "false");
+    }
+    return 0;
+}
+
+static bool openDiskTarget(const std::string& path, uint64_t size, bool direct, bool write, bool reuse,
+                           DiskTarget& t, std::string& err) {
+    struct stat st{};
+    bool exists = stat(path.c_str(), &st) == 0;
+    t.blockDev = exists && S_ISBLK(st.st_mode);
+    if (!t.blockDev && !prepareTestFile(path, size, reuse, err)) return false;
+
+    int flags = (write ? O_RDWR : O_RDONLY) | (direct ? O_DIRECT : 0);
+    t.fd = open(path.c_str(), flags);
+    if (t.fd < 0 && direct && errno == EINVAL) {
+        std::printf("note: O_DIRECT not supported on this filesystem, using buffered I/O\n");
+        t.fd = open(path.c_str(), flags & ~O_DIRECT);
+    }
+    if (t.fd < 0) { err = path + ": " + std::strerror(errno); return false; }
+    if (t.blockDev) {
+        uint64_t devSize = 0;
+        ioctl(t.fd, BLKGETSIZE64, &devSize);
+        t.size = size ? std::min(size, devSize) : devSize;
+    } else {
+        t.size = size;
+    }
+    return true;
+}
+
+// --- Disk workload driver ---
+
+struct DiskJob {
+    size_t bs = 4096;
+    bool random = true;
+    int readPct = 100;       // share of reads for mixed workloads
+};
+
+struct DiskStepResult {
+    unsigned depth = 0;
+    uint64_t ops = 0, bytes = 0, errors = 0;
+    LatencyHistogram lat;   // ns, successful requests only
+    double secs = 0;
+};
+
+static bool parseDiskPattern(const std::string& rw, DiskJob& job) {
+    if (rw == "randread")  { job.random = true;  job.readPct = 100; return true; }
+    if (rw == "randwrite") { job.random = true;  job.readPct = 0;   return true; }
+    if (rw == "randrw")    { job.random = true;  return true; }
+    if (rw == "read")      { job.random = false; job.readPct = 100; return true; }
+    if (rw == "write")     { job.random = false; job.readPct = 0;   return true; }
+    if (rw == "rw")        { job.random = false; return true; }
+    return false;
+}
+
+// Closed loop: every completion immediately re-issues on the same slot, so
+// exactly `depth` requests stay in flight for `seconds`. Live percentiles are
+// emitted once a second under `label`.
+static void runDiskStep(IoBackend& io, unsigned depth, const DiskJob& job, uint64_t span,
+                        double seconds, std::mt19937_64& rng, const std::string& label, DiskStepResult& r) {
+    r.depth = depth;
+    const uint64_t blocks = std::max<uint64_t>(1, span / job.bs);
+    uint64_t seqBlock = 0;
+    std::vector<uint64_t> started(depth);
+    std::vector<IoCompletion> done;
+    done.reserve(depth);
+
+    auto issue = [&](unsigned slot) {
+        uint64_t blk = job.random ? rng() % blocks : seqBlock++ % blocks;
+        bool write = job.readPct == 0 || (job.readPct < 100 && int(rng() % 100) >= job.readPct);
+        started[slot] = monoNs();
+        io.queue(slot, write, blk * job.bs);
+    };
+
+    const uint64_t t0 = monoNs();
+    const uint64_t end = t0 + uint64_t(seconds * 1e9);
+    uint64_t nextLive = t0 + 1000000000ull;
+    for (unsigned s = 0; s < depth; ++s) issue(s);
+    unsigned inflight = depth;
+    bool reportedError = false;
+
+    while (inflight > 0) {
+        int n = io.wait(1, done);
+        if (n < 0) {
+            std::printf("error: %s backend: %s\n", io.name().c_str(), std::strerror(-n));
+            break;
+        }
+        const uint64_t now = monoNs();
+        for (const auto& c : done) {
+            uint64_t lat = now - started[c.slot];
+            if (c.res == int(job.bs)) {
+                ++r.ops; r.bytes += job.bs;
+                r.lat.record(lat);
+            } else {
+                ++r.errors;
+                if (!reportedError) {
+                    std::printf("error: I/O returned %d (%s)\n", c.res, c.res < 0 ? std::strerror(-c.res) : "short transfer");
+                    reportedError = true;
+                }
+            }
+            if (now < end && !g_engineStop) issue(c.slot);
+            else --inflight;
+        }
+        if (now >= nextLive) { emitLatency(label, r.lat); nextLive = now + 1000000000ull; }
+    }
+    r.secs = (monoNs() - t0) / 1e9;
+}
+
+// Page-aligned request buffers filled with random bytes, so compressing or
+// deduplicating devices cannot shortcut the writes.
+struct IoBuffers {
+    std::vector<void*> ptrs;
+
+    IoBuffers(unsigned n, size_t bs, std::mt19937_64& rng) : ptrs(n, nullptr) {
+        for (auto& b : ptrs) {
+            if (posix_memalign(&b, 4096, bs) != 0) { b = nullptr; continue; }
+            auto* w = static_cast<uint64_t*>(b);
+            for (size_t i = 0; i < bs / 8; ++i) w[i] = rng();
+        }
+    }
+    ~IoBuffers() { for (void* b : ptrs) std::free(b); }
+    bool ok() const { return std::find(ptrs.begin(), ptrs.end(), nullptr) == ptrs.end(); }
+};
+
+static std::string fmtSize(uint64_t b) {
+    if (b >= (1ull << 30) && b % (1ull << 30) == 0) return std::to_string(b >> 30) + "g";
+    if (b >= (1ull << 20) && b % (1ull << 20) == 0) return std::to_string(b >> 20) + "m";
+    if (b >= 1024 && b % 1024 == 0) return std::to_string(b >> 10) + "k";
+    return std::to_string(b);
+}
+
+static void printDiskStep(const DiskStepResult& r, size_t bs) {
+    double iops = r.secs > 0 ? r.ops / r.secs : 0;
+    std::printf("%5u %12.0f %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f%s\n", r.depth, iops, iops * bs / 1048576.0,
+                r.lat.mean() / 1e3, r.lat.percentile(50) / 1e3, r.lat.percentile(99) / 1e3,
+                r.lat.percentile(99.9) / 1e3, r.lat.percentile(99.99) / 1e3,
+                r.errors ? "  (errors)" : "");
+}
+
+// Block size x access order x read share, one --runtime slice per cell. Each
+// cell is reported as a "cell" record so the GUI can draw the heatmap.
+static int runDiskMatrix(const EngineArgs& a, const std::string& path, const DiskTarget& t,
+                         unsigned depth, double runtime, std::mt19937_64& rng) {
+    static const size_t sizes[] = {4096, 16384, 65536, 262144, 1048576, 4194304};
+    static const int mixes[] = {0, 30, 50, 70, 100};
+    int rc = 0;
+    bool header = false;
+    for (size_t bs : sizes) {
+        if (g_engineStop) break;
+        if (bs > t.size) { std::printf("note: skipping bs %s (larger than target)\n", fmtSize(bs).c_str()); continue; }
+        IoBuffers bufs(depth, bs, rng);
+        if (!bufs.ok()) { std::printf("error: out of memory\n"); return 1; }
+        auto io = makeIoBackend(a.str("ioengine", "auto"), t.fd, bufs.ptrs, bs, a.flag("sqpoll"));
+        const unsigned qd = std::min(depth, io->maxDepth());
+        if (!header) {
+            std::printf("target: %s (%llu MiB)  matrix: 6 bs x seq/rand x 5 read mixes  QD %u  engine: %s\n",
+                        path.c_str(), (unsigned long long)(t.size >> 20), qd, io->name().c_str());
+            std::printf("%6s %6s %6s %12s %10s %10s %10s\n", "bs", "order", "read%", "IOPS", "MiB/s", "p50(us)", "p99(us)");
+            header = true;
+        }
+        for (bool random : {false, true}) {
+            for (int mix : mixes) {
+                if (g_engineStop) break;
+                DiskJob job;
+                job.bs = bs; job.random = random; job.readPct = mix;
+                const char* order = random ? "rand" : "seq";
+                const std::string label = fmtSize(bs) + " " + order + " r" + std::to_string(mix);
+                auto r = std::make_unique<DiskStepResult>();
+                runDiskStep(*io, qd, job, t.size, runtime, rng, label, *r);
+                double iops = r->secs > 0 ? r->ops / r->secs : 0;
+                double mibps = iops * bs / 1048576.0;
+                std::printf("%6s %6s %6d %12.0f %10.1f %10.1f %10.1f%s\n", fmtSize(bs).c_str(), order, mix,
+                            iops, mibps, r->lat.percentile(50) / 1e3, r->lat.percentile(99) / 1e3,
+                            r->errors ? "  (errors)" : "");
+                std::printf("@hst {\"type\":\"cell\",\"label\":\"%s\",\"bs\":%zu,\"order\":\"%s\",\"read\":%d,"
+                            "\"iops\":%.0f,\"mibps\":%.2f,\"p50\":%llu,\"p99\":%llu,\"p999\":%llu,\"errors\":%llu}\n",
+                            label.c_str(), bs, order, mix, iops, mibps,
+                            (unsigned long long)r->lat.percentile(50), (unsigned long long)r->lat.percentile(99),
+                            (unsigned long long)r->lat.percentile(99.9), (unsigned long long)r->errors);
+                emitHistogram(label, r->lat);
+                if (r->errors) rc = 1;
+            }
+        }
+    }
+    return rc;
+}
+
+// Several targets at once: one thread and one backend per target, all running
+// the same job for the same time. The aggregate sums throughput and merges the
+// latency histograms.
+static int runDiskMulti(const EngineArgs& a, const std::vector<std::string>& paths, const DiskJob& job,
+                        const std::string& rw, unsigned depth, double runtime) {
+    struct Target {
+        std::string path, name, engine;
+        DiskTarget t;
+        DiskStepResult r;
+    };
+    std::vector<std::unique_ptr<Target>> targets;
+    for (const auto& p : paths) {
+        auto tg = std::make_unique<Target>();
+        tg->path = p;
+        tg->name = std::filesystem::path(p).filename().string();
+        std::string err;
+        if (!openDiskTarget(p, a.bytes("size", 1ull << 30), a.flag("direct", true), job.readPct < 100,
+                            a.flag("reuse", true), tg->t, err)) {
+            std::printf("error: %s\n", err.c_str());
+            return 1;
+        }
+        if (tg->t.size < job.bs) { std::printf("error: %s is smaller than one block\n", p.c_str()); return 1; }
+        if (job.readPct < 100) forgetPreparedFile(p);
+        targets.push_back(std::move(tg));
+    }
+
+    std::printf("targets: %zu  pattern: %s  bs: %zu  QD %u per target  runtime: %.0f s\n",
+                targets.size(), rw.c_str(), job.bs, depth, runtime);
+    std::vector<std::thread> pool;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        pool.emplace_back([&, i] {
+            Target& tg = *targets[i];
+            std::mt19937_64 rng(monoNs() + i);
+            IoBuffers bufs(depth, job.bs, rng);
+            if (!bufs.ok()) { std::printf("error: %s: out of memory\n", tg.name.c_str()); tg.r.errors = 1; return; }
+            auto io = makeIoBackend(a.str("ioengine", "auto"), tg.t.fd, bufs.ptrs, job.bs, a.flag("sqpoll"));
+            tg.engine = io->name();
+            runDiskStep(*io, std::min(depth, io->maxDepth()), job, tg.t.size, runtime, rng, tg.name + " " + rw, tg.r);
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    std::printf("%-14s %-26s %5s %12s %10s %10s %10s %10s %10s\n", "target", "engine", "QD", "IOPS", "MiB/s",
+                "avg(us)", "p50(us)", "p99(us)", "p99.9(us)");
+    auto all = std::make_unique<LatencyHistogram>();
+    double allIops = 0;
+    uint64_t allErrors = 0;
+    auto row = [&](const std::string& name, const std::string& engine, unsigned qd, double iops,
+                   const LatencyHistogram& lat, uint64_t errors) {
+        std::printf("%-14s %-26s %5u %12.0f %10.1f %10.1f %10.1f %10.1f %10.1f%s\n", name.c_str(), engine.c_str(), qd,
+                    iops, iops * job.bs / 1048576.0, lat.mean() / 1e3, lat.percentile(50) / 1e3,
+                    lat.percentile(99) / 1e3, lat.percentile(99.9) / 1e3, errors ? "  (errors)" : "");
+        emitResult(name, {{"iops", iops}, {"mibps", iops * job.bs / 1048576.0}, {"qd", double(qd)},
+                          {"p50_ns", double(lat.percentile(50))}, {"p99_ns", double(lat.percentile(99))},
+                          {"p999_ns", double(lat.percentile(99.9))}, {"errors", double(errors)}});
+        emitHistogram(name, lat);
+    };
+    for (const auto& tg : targets) {
+        const double iops = tg->r.secs > 0 ? tg->r.ops / tg->r.secs : 0;
+        row(tg->name, tg->engine, tg->r.depth, iops, tg->r.lat, tg->r.errors);
+        all->merge(tg->r.lat);
+        allIops += iops;
+        allErrors += tg->r.errors;
+    }
+    row("aggregate", std::to_string(targets.size()) + " targets", depth, allIops, *all, allErrors);
+    return allErrors ? 1 : 0;
+}
+
+// hst --engine disk --file F [--size 1G] [--bs 4k] [--rw randread] [--iodepth 32]
+//     [--runtime 60] [--direct 1] [--ioengine auto|io_uring|libaio|psync] [--sqpoll 1]
+//     [--reuse 1]        (reuse a test file prepared by an earlier run)
+//     [--qd-sweep 256]   (run QD 1,2,4..N for --runtime seconds each)
+//     [--matrix 1]       (bs 4k..4m x seq/rand x read 0/30/50/70/100, --runtime per cell)
+//     [--raw-write 1]    (allow writes to raw block devices; loop devices are always allowed)
+// --file may list several comma-separated targets (e.g. /dev/nvme0n1,/dev/nvme1n1);
+// they run concurrently at --iodepth each, with per-target and aggregate results.
+static int engineDisk(const EngineArgs& a) {
+    DiskJob job;
+    job.bs = size_t(a.bytes("bs", 4096));
+    job.readPct = int(a.num("rwmixread", 50));
+    const std::string rw = a.str("rw", "randread");
+    if (!parseDiskPattern(rw, job) || job.bs == 0 || job.bs % 512) {
+        std::printf("error: bad --rw or --bs\n");
+        return 2;
+    }
+    std::vector<std::string> paths;
+    for (std::string rest = a.str("file"); !rest.empty(); ) {
+        const size_t comma = rest.find(',');
+        if (comma) paths.push_back(rest.substr(0, comma));
+        rest = comma == std::string::npos ? "" : rest.substr(comma + 1);
+    }
+    if (paths.empty()) { std::printf("error: --file is required\n"); return 2; }
+    const double runtime = std::max(1L, a.num("runtime", 60));
+    const unsigned sweepMax = unsigned(std::clamp(a.num("qd-sweep", 0), 0L, 4096L));
+    const unsigned depth = unsigned(std::clamp(a.num("iodepth", 1), 1L, 4096L));
+    const bool writes = job.readPct < 100 || a.flag("matrix");
+    std::string err;
+    for (const auto& p : paths) {
+        if (writes && !checkBlockWrite(p, a.flag("raw-write"), err)) { std::printf("error: %s\n", err.c_str()); return 1; }
+    }
+    if (paths.size() > 1) {
+        if (sweepMax || a.flag("matrix")) std::printf("note: QD sweep and matrix run on a single target only\n");
+        return runDiskMulti(a, paths, job, rw, depth, runtime);
+    }
+    const std::string& path = paths.front();
+
+    DiskTarget t;
+    if (!openDiskTarget(path, a.bytes("size", 1ull << 30), a.flag("direct", true),
+                        writes, a.flag("reuse", true), t, err)) {
+        std::printf("error: %s\n", err.c_str());
+        return 1;
+    }
+    if (t.size < job.bs) { std::printf("error: target smaller than one block\n"); return 1; }
+
+    if (writes) forgetPreparedFile(path);   // overwritten with repeated buffers: no longer the prepared data
+
+    std::mt19937_64 rng(monoNs());
+    if (a.flag("matrix")) return runDiskMatrix(a, path, t, depth, runtime, rng);
+
+    IoBuffers bufs(std::max(depth, sweepMax), job.bs, rng);
+    if (!bufs.ok()) { std::printf("error: out of memory\n"); return 1; }
+    auto io = makeIoBackend(a.str("ioengine", "auto"), t.fd, bufs.ptrs, job.bs, a.flag("sqpoll"));
+
+    std::printf("target: %s (%llu MiB%s)  pattern: %s  bs: %zu  engine: %s\n", path.c_str(),
+                (unsigned long long)(t.size >> 20), t.blockDev ? ", block device" : "",
+                rw.c_str(), job.bs, io->name().c_str());
+
+    std::vector<unsigned> depths;
+    if (sweepMax) for (unsigned d = 1; d <= sweepMax; d *= 2) depths.push_back(d);
+    else depths.push_back(depth);
+    if (depths.back() > io->maxDepth()) {
+        std::printf("note: %s has no submission queue; running at QD %u only\n", io->name().c_str(), io->maxDepth());
+        depths.assign(1, io->maxDepth());
+    }
+
+    std::printf("%5s %12s %10s %10s %10s %10s %10s %10s\n", "QD", "IOPS", "MiB/s", "avg(us)",
+                "p50(us)", "p99(us)", "p99.9(us)", "p99.99(us)");
+    int rc = 0;
+    for (unsigned d : depths) {
+        if (g_engineStop) break;
+        auto r = std::make_unique<DiskStepResult>();
+        const std::string label = rw + " QD" + std::to_string(d);
+        runDiskStep(*io, d, job, t.size, runtime, rng, label, *r);
+        printDiskStep(*r, job.bs);
+        emitLatency(label, r->lat);
+        emitHistogram(label, r->lat);
+        if (r->errors) rc = 1;
+    }
+    return rc;
+}
+
+// --- WAL commit latency ---
+
+// hst --engine wal --file F [--size 64m] [--record 4k] [--batch 1] [--runtime 60]
+//     [--sync fdatasync|fsync|odsync] [--prealloc 1]
+// Emulates a database write-ahead log: each group commit appends `batch`
+// records in one write, then makes them durable. With --prealloc the segment
+// is zero-filled first and reused circularly (as PostgreSQL does), so syncs
+// do not also have to persist file-size changes.
+static int engineWal(const EngineArgs& a) {
+    const std::string path = a.str("file");
+    if (path.empty()) { std::printf("error: --file is required\n"); return 2; }
+    const std::string sync = a.str("sync", "fdatasync");
+    if (sync != "fdatasync" && sync != "fsync" && sync != "odsync") { std::printf("error: bad --sync\n"); return 2; }
+    const size_t record = size_t(std::max<uint64_t>(1, a.bytes("record", 4096)));
+    const unsigned batch = unsigned(std::clamp(a.num("batch", 1), 1L, 65536L));
+    const uint64_t segment = std::max<uint64_t>(a.bytes("size", 64ull << 20), uint64_t(record) * batch);
+    const double runtime = std::max(1L, a.num("runtime", 60));
+    const bool prealloc = a.flag("prealloc", true);
+
+    struct stat st{};
+    if (stat(path.c_str(), &st) == 0 && !S_ISREG(st.st_mode)) {
+        std::printf("error: %s is not a regular file; the WAL test truncates its target\n", path.c_str());
+        return 2;
+    }
+    forgetPreparedFile(path);   // truncated and zero-filled below: no longer a reusable test file
+    int fd = open(path.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+    if (fd < 0) { std::printf("error: %s: %s\n", path.c_str(), std::strerror(errno)); return 1; }
+    const size_t groupBytes = record * batch;
+    std::vector<char> buf(std::max<size_t>(groupBytes, 1u << 20), 0);
+    if (prealloc) {
+        std::printf("zero-filling %llu MiB WAL segment...\n", (unsigned long long)(segment >> 20));
+        for (uint64_t off = 0; off < segment && !g_engineStop; off += buf.size()) {
+            size_t n = size_t(std::min<uint64_t>(buf.size(), segment - off));
+            if (pwrite(fd, buf.data(), n, off_t(off)) != ssize_t(n)) {
+                std::printf("error: %s: %s\n", path.c_str(), std::strerror(errno)); close(fd); return 1;
+            }
+        }
+        fsync(fd);
+    }
+    if (sync == "odsync") {
+        close(fd);
+        fd = open(path.c_str(), O_WRONLY|O_DSYNC);
+        if (fd < 0) { std::printf("error: %s: %s\n", path.c_str(), std::strerror(errno)); return 1; }
+    }
+    std::mt19937_64 rng(monoNs());
+    for (size_t i = 0; i + 8 <= groupBytes; i += 8) { uint64_t w = rng(); std::memcpy(&buf[i], &w, 8); }
+
+    std::printf("WAL: %s  record %s  group commit %u  sync %s  %s segment %s\n", path.c_str(),
+                fmtSize(record).c_str(), batch, sync.c_str(), prealloc ? "preallocated" : "appending",
+                fmtSize(segment).c_str());
+
+    auto syncLat = std::make_unique<LatencyHistogram>();    // durability step only
+    auto commitLat = std::make_unique<LatencyHistogram>();  // write + durability of a group
+    uint64_t groups = 0, off = 0;
+    const uint64_t t0 = monoNs(), end = t0 + uint64_t(runtime * 1e9);
+    uint64_t nextLive = t0 + 1000000000ull;
+    int rc = 0;
+    while (!g_engineStop) {
+        const uint64_t start = monoNs();
+        if (start >= end) break;
+        if (off + groupBytes > segment) {
+            off = 0;
+            if (!prealloc && ftruncate(fd, 0) != 0) { std::printf("error: ftruncate: %s\n", std::strerror(errno)); rc = 1; break; }
+        }
+        if (pwrite(fd, buf.data(), groupBytes, off_t(off)) != ssize_t(groupBytes)) {
+            std::printf("error: write: %s\n", std::strerror(errno)); rc = 1; break;
+        }
+        off += groupBytes;
+        const uint64_t written = monoNs();
+        int r = 0;
+        if (sync == "fdatasync") r = fdatasync(fd);
+        else if (sync == "fsync") r = fsync(fd);
+        if (r != 0) { std::printf("error: %s: %s\n", sync.c_str(), std::strerror(errno)); rc = 1; break; }
+        const uint64_t now = monoNs();
+        // With O_DSYNC the write itself is the durability step.
+        syncLat->record(sync == "odsync" ? now - start : now - written);
+        commitLat->record(now - start);
+        ++groups;
+        if (now >= nextLive) { emitLatency("wal sync", *syncLat); nextLive = now + 1000000000ull; }
+    }
+    close(fd);
+
+    const double secs = (monoNs() - t0) / 1e9;
+    const double commits = double(groups) * batch / secs, syncs = double(groups) / secs;
+    std::printf("%12s %12s %10s %10s %10s %10s %10s\n", "commits/s", "syncs/s", "MiB/s",
+                "p50(us)", "p99(us)", "p99.9(us)", "max(us)");
+    std::printf("%12.0f %12.0f %10.2f %10.1f %10.1f %10.1f %10.1f\n", commits, syncs,
+                syncs * groupBytes / 1048576.0, syncLat->percentile(50) / 1e3, syncLat->percentile(99) / 1e3,
+                syncLat->percentile(99.9) / 1e3, syncLat->max() / 1e3);
+    std::printf("group commit latency (write + sync): p50 %.1f us, p99 %.1f us\n",
+                commitLat->percentile(50) / 1e3, commitLat->percentile(99) / 1e3);
+    emitLatency("wal sync", *syncLat);
+    emitHistogram("wal sync", *syncLat);
+    emitHistogram("wal commit", *commitLat);
+    emitResult("wal", {{"commits_per_sec", commits}, {"syncs_per_sec", syncs}, {"record_bytes", double(record)},
+                       {"batch", double(batch)}, {"sync_p50_ns", double(syncLat->percentile(50))},
+                       {"sync_p99_ns", double(syncLat->percentile(99))},
+                       {"sync_p999_ns", double(syncLat->percentile(99.9))}});
+    return rc;
+}
+
+// --- Filesystem metadata ---
+
+static void emitProgress(double fraction) {
+    std::printf("@hst {\"type\":\"progress\",\"fraction\":%.4f}\n", std::clamp(fraction, 0.0, 1.0));
+}
+
+// Removes a metadata tree: the entries are listed up front, then unlinked by
+// --threads workers so a large tree is gone before the GUI's stop timeout.
+static void removeMetaTree(const std::string& root, unsigned threads) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    std::vector<fs::path> dirs, files;
+    for (const auto& d : fs::directory_iterator(root, ec)) {
+        if (!d.is_directory(ec)) { files.push_back(d.path()); continue; }
+        dirs.push_back(d.path());
+        for (const auto& e : fs::directory_iterator(d.path(), ec)) files.push_back(e.path());
+    }
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < std::max(1u, threads); ++t)
+        pool.emplace_back([&] {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < files.size();)
+                unlink(files[i].c_str());
+        });
+    for (auto& th : pool) th.join();
+    for (const auto& d : dirs) rmdir(d.c_str());
+    rmdir(root.c_str());
+}
+
+// hst --engine meta --dir D [--files 100000] [--fanout 100] [--threads N] [--size 0]
+// Creates, stats, renames (into the next directory) and unlinks --files small
+// files spread over --fanout directories, each phase split across --threads.
+static int engineMeta(const EngineArgs& a) {
+    const std::string dir = a.str("dir");
+    if (dir.empty()) { std::printf("error: --dir is required\n"); return 2; }
+    const uint64_t files = uint64_t(std::max(1L, a.num("files", 100000)));
+    const unsigned fanout = unsigned(std::clamp(a.num("fanout", 100), 1L, 1000000L));
+    const unsigned threads = unsigned(std::clamp(a.num("threads", long(std::thread::hardware_concurrency())), 1L, 1024L));
+    const size_t fileSize = size_t(a.bytes("size", 0));
+
+    // A run killed before its cleanup leaves hst-meta-<pid>; sweep those whose owner is gone.
+    std::error_code ec;
+    for (const auto& e : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string name = e.path().filename().string();
+        if (name.rfind("hst-meta-", 0) != 0) continue;
+        const long pid = std::strtol(name.c_str() + 9, nullptr, 10);
+        if (pid > 0 && kill(pid_t(pid), 0) != 0 && errno == ESRCH) {
+            std::printf("removing stale %s\n", e.path().c_str());
+            removeMetaTree(e.path().string(), threads);
+        }
+    }
+
+    const std::string root = dir + "/hst-meta-" + std::to_string(getpid());
+    if (mkdir(root.c_str(), 0755) != 0) { std::printf("error: %s: %s\n", root.c_str(), std::strerror(errno)); return 1; }
+    for (unsigned d = 0; d < fanout; ++d) mkdir((root + "/d" + std::to_string(d)).c_str(), 0755);
+    std::printf("metadata: %s  files %llu  dirs %u  threads %u  file size %s\n", root.c_str(),
+                (unsigned long long)files, fanout, threads, fmtSize(fileSize).c_str());
+
+    // Paths are formatted into a stack buffer outside the timed region.
+    auto pathOf = [&](char* out, uint64_t i, bool renamed) {
+        unsigned d = unsigned((i + (renamed ? 1 : 0)) % fanout);
+        std::snprintf(out, PATH_MAX, "%s/d%u/%c%llu", root.c_str(), d, renamed ? 'r' : 'f', (unsigned long long)i);
+    };
+    std::vector<char> payload(std::max<size_t>(fileSize, 1), 'h');
+
+    static const char* opNames[] = {"create", "stat", "rename", "unlink"};
+    std::printf("%8s %12s %10s %10s %10s %10s\n", "op", "ops/s", "p50(us)", "p99(us)", "p99.9(us)", "errors");
+    int rc = 0;
+    for (int op = 0; op < 4 && !g_engineStop; ++op) {
+        std::atomic<uint64_t> done{0}, errors{0};
+        std::atomic<unsigned> running{threads};
+        std::vector<std::unique_ptr<LatencyHistogram>> hist(threads);
+        std::vector<std::thread> pool;
+        const uint64_t t0 = monoNs();
+        for (unsigned t = 0; t < threads; ++t) {
+            hist[t] = std::make_unique<LatencyHistogram>();
+            pool.emplace_back([&, t] {
+                char p1[PATH_MAX], p2[PATH_MAX];
+                struct stat st{};
+                for (uint64_t i = t; i < files && !g_engineStop; i += threads) {
+                    pathOf(p1, i, op == 3);
+                    if (op == 2) pathOf(p2, i, true);
+                    const uint64_t s0 = monoNs();
+                    bool ok = true;
+                    switch (op) {
+                    case 0: {
+                        int fd = open(p1, O_WRONLY|O_CREAT|O_EXCL, 0644);
+                        ok = fd >= 0;
+                        if (ok && fileSize) ok = write(fd, payload.data(), fileSize) == ssize_t(fileSize);
+                        if (fd >= 0) close(fd);
+                        break;
+                    }
+                    case 1: ok = stat(p1, &st) == 0; break;
+                    case 2: ok = rename(p1, p2) == 0; break;
+                    default: ok = unlink(p1) == 0; break;
+                    }
+                    if (ok) hist[t]->record(monoNs() - s0); else ++errors;
+                    done.fetch_add(1, std::memory_order_relaxed);
+                }
+                --running;
+            });
+        }
+        uint64_t nextLive = t0 + 1000000000ull;
+        while (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (monoNs() >= nextLive) {
+                emitProgress((op + double(done) / double(files)) / 4.0);
+                nextLive += 1000000000ull;
+            }
+        }
+        for (auto& th : pool) th.join();
+        const double secs = (monoNs() - t0) / 1e9;
+
+        auto merged = std::make_unique<LatencyHistogram>();
+        for (auto& h : hist) merged->merge(*h);
+        const double rate = merged->count() / secs;
+        std::printf("%8s %12.0f %10.1f %10.1f %10.1f %10llu\n", opNames[op], rate,
+                    merged->percentile(50) / 1e3, merged->percentile(99) / 1e3, merged->percentile(99.9) / 1e3,
+                    (unsigned long long)errors.load());
+        const std::string label = std::string("meta ") + opNames[op];
+        emitLatency(label, *merged);
+        emitHistogram(label, *merged);
+        emitResult(label, {{"ops_per_sec", rate}, {"p50_ns", double(merged->percentile(50))},
+                           {"p99_ns", double(merged->percentile(99))}, {"p999_ns", double(merged->percentile(99.9))},
+                           {"errors", double(errors.load())}});
+        if (errors) rc = 1;
+    }
+
+    // Remove the tree, including files a stopped phase never reached.
+    removeMetaTree(root, threads);
+    return rc;
+}
+
+// --- End-to-end data verification ---
+
+// Raw CRC32C register update, so a checksum can be taken over several pieces:
+// crc32c(data, n) == ~crc32cUpdate(~0u, data, n).
+static uint32_t crc32cUpdate(uint32_t c, const void* data, size_t n) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+            t[i] = c;
+        }
+        return t;
+    }();
+    const auto* p = static_cast<const uint8_t*>(data);
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2")) {
+        struct Hw {
+            __attribute__((target("sse4.2"))) static uint32_t run(const uint8_t* p, size_t n, uint32_t c) {
+                uint64_t c64 = c;
+                for (; n >= 8; n -= 8, p += 8) { uint64_t w; std::memcpy(&w, p, 8); c64 = __builtin_ia32_crc32di(c64, w); }
+                c = uint32_t(c64);
+                for (; n; --n) c = __builtin_ia32_crc32qi(c, *p++);
+                return c;
+            }
+        };
+        return Hw::run(p, n, c);
+    }
+#endif
+    for (; n; --n) c = table[(c ^ *p++) & 0xff] ^ (c >> 8);
+    return c;
+}
+
+static uint32_t crc32c(const void* data, size_t n) { return ~crc32cUpdate(~0u, data, n); }
+
+// Every 512-byte sector of a verify block starts with this header; the rest is
+// a pseudo-random stream derived from (run, offset, seq, sector), so the
+// expected content of any sector can be regenerated on read-back.
+struct VerifySectorHeader {
+    uint32_t magic;
+    uint32_t crc;       // sector 0 only: CRC32C of the block with this field zeroed
+    uint64_t offset;    // byte offset the block was written to (LBA tag)
+    uint64_t seq;       // write pass that produced the block
+    uint64_t runId;
+};
+static constexpr uint32_t kVerifyMagic = 0x56545348;   // "HSTV"
+static constexpr size_t kSector = 512;
+
+static void fillVerifySector(uint8_t* sec, uint64_t runId, uint64_t offset, uint64_t seq, size_t index) {
+    VerifySectorHeader h{kVerifyMagic, 0, offset, seq, runId};
+    std::memcpy(sec, &h, sizeof(h));
+    // splitmix64 stream
+    uint64_t x = runId ^ (offset * 0x9E3779B97F4A7C15ull) ^ (seq << 48) ^ (uint64_t(index) << 32);
+    for (size_t i = sizeof(h); i < kSector; i += 8) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z ^= z >> 31;
+        std::memcpy(sec + i, &z, 8);
+    }
+}
+
+static void fillVerifyBlock(uint8_t* blk, size_t bs, uint64_t runId, uint64_t offset, uint64_t seq) {
+    for (size_t s = 0; s < bs / kSector; ++s) fillVerifySector(blk + s*kSector, runId, offset, seq, s);
+    uint32_t crc = crc32c(blk, bs);
+    std::memcpy(blk + offsetof(VerifySectorHeader, crc), &crc, 4);
+}
+
+struct VerifyCounts { uint64_t ok = 0, misdirected = 0, torn = 0, stale = 0, bitrot = 0; };
+
+// Classify one block read back from `offset`; prints and records anything wrong.
+static void verifyBlock(const uint8_t* blk, size_t bs, uint64_t runId, uint64_t offset, uint64_t seq,
+                        VerifyCounts& vc, uint64_t& reported) {
+    auto report = [&](const char* kind, const std::string& detail) {
+        if (++reported <= 200) {
+            std::printf("%-11s offset 0x%llx: %s\n", kind, (unsigned long long)offset, detail.c_str());
+            std::printf("@hst {\"type\":\"verify_error\",\"kind\":\"%s\",\"offset\":%llu,\"detail\":\"%s\"}\n",
+                        kind, (unsigned long long)offset, detail.c_str());
+        } else if (reported == 201) {
+            std::printf("(further errors are counted but not listed)\n");
+        }
+    };
+    VerifySectorHeader h0;
+    std::memcpy(&h0, blk, sizeof(h0));
+    // CRC of the block with its CRC field read as zero, taken in place around the field
+    static constexpr size_t kCrcOff = offsetof(VerifySectorHeader, crc);
+    static const uint8_t zero[4] = {};
+    uint32_t c = crc32cUpdate(~0u, blk, kCrcOff);
+    c = crc32cUpdate(c, zero, 4);
+    c = ~crc32cUpdate(c, blk + kCrcOff + 4, bs - kCrcOff - 4);
+    const bool crcOk = h0.magic == kVerifyMagic && c == h0.crc;
+
+    if (crcOk) {
+        if (h0.offset != offset) {
+            ++vc.misdirected;
+            char d[160];
+            std::snprintf(d, sizeof d, "holds the block written for offset 0x%llx (seq %llu)",
+                          (unsigned long long)h0.offset, (unsigned long long)h0.seq);
+            report("MISDIRECTED", d);
+        } else if (h0.seq != seq || h0.runId != runId) {
+            ++vc.stale;
+            char d[160];
+            std::snprintf(d, sizeof d, "intact block from seq %llu%s, expected seq %llu (lost write)",
+                          (unsigned long long)h0.seq, h0.runId != runId ? " of another run" : "",
+                          (unsigned long long)seq);
+            report("STALE", d);
+        } else {
+            ++vc.ok;
+        }
+        return;
+    }
+
+    // Checksum failed: compare each sector with what this and older passes wrote.
+    const size_t sectors = bs / kSector;
+    std::array<uint8_t, kSector> want;
+    size_t current = 0, older = 0, corrupt = 0, firstBad = SIZE_MAX, badBytes = 0, badBits = 0;
+    uint8_t gotByte = 0, wantByte = 0;
+    for (size_t s = 0; s < sectors; ++s) {
+        const uint8_t* sec = blk + s*kSector;
+        fillVerifySector(want.data(), runId, offset, seq, s);
+        if (s == 0) std::memcpy(want.data() + offsetof(VerifySectorHeader, crc), &h0.crc, 4);
+        if (std::memcmp(sec, want.data(), kSector) == 0) { ++current; continue; }
+        VerifySectorHeader h;
+        std::memcpy(&h, sec, sizeof(h));
+        if (h.magic == kVerifyMagic && h.offset == offset && h.runId == runId && h.seq < seq) {
+            fillVerifySector(want.data(), runId, offset, h.seq, s);
+            if (std::memcmp(sec + sizeof(h), want.data() + sizeof(h), kSector - sizeof(h)) == 0) { ++older; continue; }
+            fillVerifySector(want.data(), runId, offset, seq, s);
+        }
+        ++corrupt;
+        for (size_t i = 0; i < kSector; ++i) {
+            if (s == 0 && i >= offsetof(VerifySectorHeader, crc) && i < offsetof(VerifySectorHeader, crc) + 4) continue;
+            if (sec[i] == want[i]) continue;
+            if (firstBad == SIZE_MAX) { firstBad = s*kSector + i; gotByte = sec[i]; wantByte = want[i]; }
+            ++badBytes;
+            badBits += size_t(__builtin_popcount(unsigned(sec[i] ^ want[i])));
+        }
+    }
+    char d[200];
+    if (corrupt == 0 && older > 0 && current > 0) {
+        ++vc.torn;
+        std::snprintf(d, sizeof d, "%zu of %zu sectors from seq %llu, %zu from an older write",
+                      current, sectors, (unsigned long long)seq, older);
+        report("TORN", d);
+    } else if (firstBad == SIZE_MAX) {
+        ++vc.bitrot;
+        report("BITROT", "checksum field itself is corrupt");
+    } else {
+        ++vc.bitrot;
+        std::snprintf(d, sizeof d, "%zu byte(s) / %zu bit(s) differ in %zu sector(s); first at 0x%llx: "
+                      "expected 0x%02x got 0x%02x", badBytes, badBits, corrupt,
+                      (unsigned long long)(offset + firstBad), wantByte, gotByte);
+        report("BITROT", d);
+    }
+}
+
+static void dropCaches(int fd) {
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    if (geteuid() == 0) {
+        sync();
+        if (FILE* f = std::fopen("/proc/sys/vm/drop_caches", "w")) { std::fputs("3", f); std::fclose(f); }
+    }
+}
+
+// hst --engine verify --file F [--size 1G] [--bs 4k] [--passes 2] [--direct 1]
+//     [--drop-caches 1] [--raw-write 1] [--reuse 1]
+// Each pass writes every block (seq = pass number) in random order, syncs,
+// optionally drops caches, then reads everything back and verifies it.
+static int engineVerify(const EngineArgs& a) {
+    const std::string path = a.str("file");
+    if (path.empty()) { std::printf("error: --file is required\n"); return 2; }
+    const size_t bs = size_t(a.bytes("bs", 4096));
+    if (bs < kSector || bs % kSector) { std::printf("error: --bs must be a multiple of 512\n"); return 2; }
+    const unsigned passes = unsigned(std::clamp(a.num("passes", 2), 1L, 1000L));
+    const bool direct = a.flag("direct", true);
+    const bool drop = a.flag("drop-caches");
+
+    std::string err;
+    if (!checkBlockWrite(path, a.flag("raw-write"), err)) { std::printf("error: %s\n", err.c_str()); return 2; }
+    DiskTarget t;
+    if (!openDiskTarget(path, a.bytes("size", 1ull << 30), direct, true, a.flag("reuse", true), t, err)) {
+        std::printf("error: %s\n", err.c_str());
+        return 1;
+    }
+    const uint64_t blocks = t.size / bs;
+    if (!blocks) { std::printf("error: target smaller than one block\n"); return 1; }
+
+    const size_t chunkBlocks = std::max<size_t>(1, (1u << 20) / bs);
+    void* mem = nullptr;
+    if (posix_memalign(&mem, 4096, chunkBlocks * bs) != 0) { std::printf("error: out of memory\n"); return 1; }
+    std::unique_ptr<void, decltype(&std::free)> hold(mem, &std::free);
+    auto* buf = static_cast<uint8_t*>(mem);
+
+    std::mt19937_64 rng(monoNs());
+    const uint64_t runId = rng();
+    std::printf("verify: %s (%llu MiB)  bs %s  passes %u  %s%s  run %016llx\n", path.c_str(),
+                (unsigned long long)(t.size >> 20), fmtSize(bs).c_str(), passes, direct ? "O_DIRECT" : "buffered",
+                drop ? ", caches dropped before read-back" : "", (unsigned long long)runId);
+
+    // Chunks are written in shuffled order so neighbouring blocks do not
+    // share a single large request.
+    std::vector<uint64_t> order((blocks + chunkBlocks - 1) / chunkBlocks);
+    for (uint64_t i = 0; i < order.size(); ++i) order[i] = i;
+
+    VerifyCounts vc;
+    uint64_t reported = 0, ioErrors = 0;
+    const double steps = 2.0 * passes;
+    for (unsigned pass = 1; pass <= passes && !g_engineStop; ++pass) {
+        std::shuffle(order.begin(), order.end(), rng);
+        uint64_t t0 = monoNs(), done = 0;
+        for (uint64_t c : order) {
+            if (g_engineStop) break;
+            const uint64_t first = c * chunkBlocks, n = std::min<uint64_t>(chunkBlocks, blocks - first);
+            for (uint64_t b = 0; b < n; ++b) fillVerifyBlock(buf + b*bs, bs, runId, (first + b) * bs, pass);
+            if (pwrite(t.fd, buf, n*bs, off_t(first*bs)) != ssize_t(n*bs)) {
+                if (!ioErrors++) std::printf("error: write at 0x%llx: %s\n", (unsigned long long)(first*bs), std::strerror(errno));
+            }
+            if (++done % 256 == 0) emitProgress((2*(pass-1) + double(done) / order.size()) / steps);
+        }
+        fsync(t.fd);
+        const double wsecs = (monoNs() - t0) / 1e9;
+        if (drop) dropCaches(t.fd);
+
+        const VerifyCounts before = vc;
+        t0 = monoNs();
+        for (uint64_t first = 0; first < blocks && !g_engineStop; first += chunkBlocks) {
+            const uint64_t n = std::min<uint64_t>(chunkBlocks, blocks - first);
+            if (pread(t.fd, buf, n*bs, off_t(first*bs)) != ssize_t(n*bs)) {
+                if (!ioErrors++) std::printf("error: read at 0x%llx: %s\n", (unsigned long long)(first*bs), std::strerror(errno));
+                continue;
+            }
+            for (uint64_t b = 0; b < n; ++b) verifyBlock(buf + b*bs, bs, runId, (first + b) * bs, pass, vc, reported);
+            if ((first / chunkBlocks) % 256 == 0) emitProgress((2*pass - 1 + double(first) / blocks) / steps);
+        }
+        const double rsecs = (monoNs() - t0) / 1e9;
+        const double mib = double(blocks * bs) / 1048576.0;
+        std::printf("pass %u: wrote %.0f MiB/s, verified %.0f MiB/s, %llu bad block(s)\n", pass, mib / wsecs, mib / rsecs,
+                    (unsigned long long)((vc.misdirected + vc.torn + vc.stale + vc.bitrot) -
+                                         (before.misdirected + before.torn + before.stale + before.bitrot)));
+    }
+
+    std::printf("blocks ok %llu  misdirected %llu  torn %llu  stale %llu  bit rot %llu  I/O errors %llu\n",
+                (unsigned long long)vc.ok, (unsigned long long)vc.misdirected, (unsigned long long)vc.torn,
+                (unsigned long long)vc.stale, (unsigned long long)vc.bitrot, (unsigned long long)ioErrors);
+    emitResult("verify", {{"blocks_ok", double(vc.ok)}, {"misdirected", double(vc.misdirected)},
+                          {"torn", double(vc.torn)}, {"stale", double(vc.stale)}, {"bitrot", double(vc.bitrot)},
+                          {"io_errors", double(ioErrors)}});
+    const bool clean = !vc.misdirected && !vc.torn && !vc.stale && !vc.bitrot && !ioErrors;
+    std::printf("%s\n", clean ? "VERIFY PASSED" : "VERIFY FAILED");
+    return clean ? 0 : 3;
+}
+
+// --- Page cache (buffered I/O) ---
+
+// read_ahead_kb of the request queue behind `fd`, or "" when there is none
+// (tmpfs, btrfs anonymous devices, ...). Partitions use their disk's queue.
+static std::string readAheadPath(int fd) {
+    struct stat st{};
+    if (fstat(fd, &st) != 0) return "";
+    const std::string base = "/sys/dev/block/" + std::to_string(major(st.st_dev)) + ":" + std::to_string(minor(st.st_dev));
+    for (const char* rel : {"/queue/read_ahead_kb", "/../queue/read_ahead_kb"})
+        if (access((base + rel).c_str(), R_OK) == 0) return base + rel;
+    return "";
+}
+
+static bool writeSysfs(const std::string& path, const std::string& value) {
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    bool ok = std::fputs(value.c_str(), f) >= 0;
+    return std::fclose(f) == 0 && ok;
+}
+
+// Sequential buffered pass over [0, size) in `bs` chunks, stopped after
+// `seconds`. Returns MiB/s; `write` overwrites and includes the final flush.
+static double bufferedPass(int fd, uint64_t size, void* buf, size_t bs, bool write, double seconds,
+                           double* dirtyMibps = nullptr) {
+    const uint64_t t0 = monoNs(), end = t0 + uint64_t(seconds * 1e9);
+    uint64_t done = 0;
+    for (uint64_t off = 0; off < size && !g_engineStop; off += bs) {
+        const size_t n = size_t(std::min<uint64_t>(bs, size - off));
+        ssize_t r = write ? pwrite(fd, buf, n, off_t(off)) : pread(fd, buf, n, off_t(off));
+        if (r <= 0) break;
+        done += uint64_t(r);
+        if ((done & ((64u << 20) - 1)) < bs && monoNs() >= end) break;
+    }
+    if (write) {
+        if (dirtyMibps) *dirtyMibps = done / 1048576.0 / ((monoNs() - t0) / 1e9);
+        fdatasync(fd);
+    }
+    return done / 1048576.0 / ((monoNs() - t0) / 1e9);
+}
+
+// hst --engine cache --file F [--size 1G] [--bs 128k] [--runtime 10]
+//     [--readahead 128,512,2048] [--reuse 1]
+// Buffered (page cache) I/O. For every read_ahead_kb setting: sequential and
+// 4k random reads from a cold cache. Then the same from a warm cache, and a
+// buffered sequential overwrite with and without its flush. Cold means
+// drop_caches when running as root, posix_fadvise(DONTNEED) otherwise.
+// Changing read_ahead_kb needs root; the original value is restored.
+static int engineCache(const EngineArgs& a) {
+    const std::string path = a.str("file");
+    if (path.empty()) { std::printf("error: --file is required\n"); return 2; }
+    const size_t bs = size_t(a.bytes("bs", 128 << 10));
+    const double runtime = std::max(1L, a.num("runtime", 10));
+    std::string err;
+    if (!checkBlockWrite(path, a.flag("raw-write"), err)) { std::printf("error: %s\n", err.c_str()); return 2; }
+    DiskTarget t;
+    if (!openDiskTarget(path, a.bytes("size", 1ull << 30), false, true, a.flag("reuse", true), t, err)) {
+        std::printf("error: %s\n", err.c_str());
+        return 1;
+    }
+    if (t.size < bs) { std::printf("error: target smaller than one block\n"); return 1; }
+
+    const std::string raPath = readAheadPath(t.fd);
+    const std::string raOrig = raPath.empty() ? "" : readSysfs(raPath);
+    std::vector<std::string> settings;
+    if (raPath.empty()) {
+        std::printf("note: no block queue behind %s; read_ahead_kb cannot be varied\n", path.c_str());
+    } else if (access(raPath.c_str(), W_OK) != 0) {
+        std::printf("note: read_ahead_kb is %s KiB; changing it needs root\n", raOrig.c_str());
+    } else {
+        for (std::string rest = a.str("readahead", "128,512,2048"); !rest.empty(); ) {
+            const size_t comma = rest.find(',');
+            if (comma) settings.push_back(rest.substr(0, comma));
+            rest = comma == std::string::npos ? "" : rest.substr(comma + 1);
+        }
+    }
+    if (settings.empty()) settings.push_back(raOrig.empty() ? "-" : raOrig);
+    std::printf("page cache: %s (%llu MiB)  seq bs: %s  cold cache via %s  read_ahead_kb: %s\n", path.c_str(),
+                (unsigned long long)(t.size >> 20), fmtSize(bs).c_str(),
+                geteuid() == 0 ? "drop_caches" : "fadvise(DONTNEED)", raOrig.empty() ? "n/a" : raOrig.c_str());
+
+    std::mt19937_64 rng(monoNs());
+    IoBuffers seqBuf(1, bs, rng), rndBuf(1, 4096, rng);
+    if (!seqBuf.ok() || !rndBuf.ok()) { std::printf("error: out of memory\n"); return 1; }
+    PsyncBackend io(t.fd, rndBuf.ptrs, 4096);
+    DiskJob rnd;
+    rnd.bs = 4096; rnd.random = true; rnd.readPct = 100;
+
+    const double phases = double(settings.size() * 2 + 3);
+    int phase = 0;
+    std::printf("%-18s %10s %10s %12s %10s %10s\n", "phase", "ra(KiB)", "MiB/s", "IOPS", "p50(us)", "p99(us)");
+    auto randomRead = [&](const std::string& label, const std::string& ra) {
+        auto r = std::make_unique<DiskStepResult>();
+        runDiskStep(io, 1, rnd, t.size, runtime, rng, label, *r);
+        const double iops = r->secs > 0 ? r->ops / r->secs : 0;
+        std::printf("%-18s %10s %10.1f %12.0f %10.1f %10.1f\n", label.c_str(), ra.c_str(), iops * 4096 / 1048576.0,
+                    iops, r->lat.percentile(50) / 1e3, r->lat.percentile(99) / 1e3);
+        emitResult(label + (ra == "-" ? "" : " ra" + ra), {{"iops", iops}, {"p50_ns", double(r->lat.percentile(50))},
+                   {"p99_ns", double(r->lat.percentile(99))}, {"readahead_kb", std::atof(ra.c_str())}});
+        emitHistogram(label + (ra == "-" ? "" : " ra" + ra), r->lat);
+        emitProgress(++phase / phases);
+    };
+    auto seqRead = [&](const std::string& label, const std::string& ra) {
+        const double mibps = bufferedPass(t.fd, t.size, seqBuf.ptrs[0], bs, false, runtime);
+        std::printf("%-18s %10s %10.1f\n", label.c_str(), ra.c_str(), mibps);
+        emitResult(label + (ra == "-" ? "" : " ra" + ra), {{"mibps", mibps}, {"readahead_kb", std::atof(ra.c_str())}});
+        emitProgress(++phase / phases);
+    };
+
+    bool raChanged = false;
+    for (const auto& ra : settings) {
+        if (g_engineStop) break;
+        if (ra != raOrig && ra != "-") {
+            if (!writeSysfs(raPath, ra)) {
+                std::printf("note: could not set read_ahead_kb=%s\n", ra.c_str());
+                continue;
+            }
+            raChanged = true;
+        }
+        dropCaches(t.fd);
+        seqRead("cold seq read", ra);
+        dropCaches(t.fd);
+        randomRead("cold rand 4k read", ra);
+    }
+    // Whatever the loop changed, and however it ended, the device gets its own value back
+    if (raChanged && !writeSysfs(raPath, raOrig))
+        std::printf("warning: could not restore read_ahead_kb=%s on %s\n", raOrig.c_str(), raPath.c_str());
+
+    // Warm: pull the whole file in first, so both passes are served from memory
+    const std::string ra = raOrig.empty() ? "-" : raOrig;
+    if (!g_engineStop) {
+        posix_fadvise(t.fd, 0, 0, POSIX_FADV_WILLNEED);
+        bufferedPass(t.fd, t.size, seqBuf.ptrs[0], bs, false, 1e9);
+        seqRead("warm seq read", ra);
+        randomRead("warm rand 4k read", ra);
+    }
+    if (!g_engineStop) {
+        double dirty = 0;
+        const double flushed = bufferedPass(t.fd, t.size, seqBuf.ptrs[0], bs, true, runtime, &dirty);
+        std::printf("%-18s %10s %10.1f\n", "seq write (dirty)", ra.c_str(), dirty);
+        std::printf("%-18s %10s %10.1f\n", "seq write (+flush)", ra.c_str(), flushed);
+        emitResult("buffered write", {{"dirty_mibps", dirty}, {"flushed_mibps", flushed}});
+        forgetPreparedFile(path);   // one repeated buffer now, no longer incompressible
+        emitProgress(1.0);
+    }
+    return 0;
+}
+
+// --- Memory-mapped I/O ---
+
+struct FaultCounts { long major = 0, minor = 0; };
+
+static FaultCounts faultCounts() {
+    struct rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return {ru.ru_majflt, ru.ru_minflt};
+}
+
+// Closed loop at QD 1 over a shared mapping: every op copies `bs` bytes out
+// of (or into) the mapping, so the cost of each page fault lands in the
+// op's latency exactly as it would for a mmap-based storage engine.
+static void runMmapStep(uint8_t* map, void* buf, const DiskJob& job, uint64_t span, double seconds,
+                        std::mt19937_64& rng, const std::string& label, DiskStepResult& r) {
+    r.depth = 1;
+    const uint64_t blocks = std::max<uint64_t>(1, span / job.bs);
+    uint64_t seqBlock = 0, sink = 0;
+    const uint64_t t0 = monoNs(), end = t0 + uint64_t(seconds * 1e9);
+    uint64_t nextLive = t0 + 1000000000ull;
+    for (uint64_t now = t0; now < end && !g_engineStop; ) {
+        const uint64_t blk = job.random ? rng() % blocks : seqBlock++ % blocks;
+        const bool write = job.readPct == 0 || (job.readPct < 100 && int(rng() % 100) >= job.readPct);
+        uint8_t* p = map + blk * job.bs;
+        const uint64_t s0 = monoNs();
+        if (write) std::memcpy(p, buf, job.bs);
+        else { std::memcpy(buf, p, job.bs); sink += *static_cast<const uint64_t*>(buf); }
+        now = monoNs();
+        r.lat.record(now - s0);
+        ++r.ops; r.bytes += job.bs;
+        if (now >= nextLive) { emitLatency(label, r.lat); nextLive = now + 1000000000ull; }
+    }
+    r.secs = (monoNs() - t0) / 1e9;
+    static std::atomic<uint64_t> keep;   // keeps the copies observable
+    keep.store(sink, std::memory_order_relaxed);
+}
+
+// hst --engine mmap --file F [--size 1G] [--bs 4k] [--rw randread] [--runtime 10]
+//     [--advise normal|random|sequential|willneed|hugepage] [--populate 1]
+//     [--compare 1] [--iodepth 1] [--reuse 1]
+// Page-fault-driven I/O through a MAP_SHARED mapping, from a cold cache. With
+// --compare the same pattern then runs through buffered pread/pwrite and
+// io_uring (at --iodepth) on the same file, each from a cold cache too.
+// Writes are flushed at the end of each method (msync / fdatasync) and the
+// flush time is reported separately.
+static int engineMmap(const EngineArgs& a) {
+    DiskJob job;
+    job.bs = size_t(a.bytes("bs", 4096));
+    job.readPct = int(a.num("rwmixread", 50));
+    const std::string rw = a.str("rw", "randread");
+    if (!parseDiskPattern(rw, job) || job.bs == 0 || job.bs % 512) { std::printf("error: bad --rw or --bs\n"); return 2; }
+    const std::string path = a.str("file");
+    if (path.empty()) { std::printf("error: --file is required\n"); return 2; }
+    const double runtime = std::max(1L, a.num("runtime", 10));
+    const unsigned depth = unsigned(std::clamp(a.num("iodepth", 1), 1L, 4096L));
+    const bool writes = job.readPct < 100;
+    static const std::map<std::string, int> advice {
+        {"normal", MADV_NORMAL}, {"random", MADV_RANDOM}, {"sequential", MADV_SEQUENTIAL},
+        {"willneed", MADV_WILLNEED}, {"hugepage", MADV_HUGEPAGE}};
+    const std::string advise = a.str("advise", "normal");
+    if (!advice.count(advise)) { std::printf("error: bad --advise\n"); return 2; }
+
+    std::string err;
+    if (writes && !checkBlockWrite(path, a.flag("raw-write"), err)) { std::printf("error: %s\n", err.c_str()); return 2; }
+    DiskTarget t;
+    if (!openDiskTarget(path, a.bytes("size", 1ull << 30), false, writes, a.flag("reuse", true), t, err)) {
+        std::printf("error: %s\n", err.c_str());
+        return 1;
+    }
+    if (t.size < job.bs) { std::printf("error: target smaller than one block\n"); return 1; }
+    const uint64_t span = t.size / job.bs * job.bs;
+
+    std::mt19937_64 rng(monoNs());
+    IoBuffers bufs(depth, job.bs, rng);
+    if (!bufs.ok()) { std::printf("error: out of memory\n"); return 1; }
+
+    std::printf("mmap: %s (%llu MiB)  pattern: %s  bs: %zu  madvise: %s%s\n", path.c_str(),
+                (unsigned long long)(span >> 20), rw.c_str(), job.bs, advise.c_str(),
+                a.flag("populate") ? "  MAP_POPULATE" : "");
+    std::printf("%-26s %5s %12s %10s %10s %10s %10s %10s %10s %10s\n", "method", "QD", "IOPS", "MiB/s", "p50(us)",
+                "p99(us)", "p99.9(us)", "flush(ms)", "majflt", "minflt");
+    int rc = 0;
+    auto report = [&](const std::string& method, const DiskStepResult& r, double flushMs, const FaultCounts& f) {
+        const double iops = r.secs > 0 ? r.ops / r.secs : 0;
+        std::printf("%-26s %5u %12.0f %10.1f %10.1f %10.1f %10.1f %10.1f %10ld %10ld%s\n", method.c_str(), r.depth,
+                    iops, iops * job.bs / 1048576.0, r.lat.percentile(50) / 1e3, r.lat.percentile(99) / 1e3,
+                    r.lat.percentile(99.9) / 1e3, flushMs, f.major, f.minor, r.errors ? "  (errors)" : "");
+        const std::string label = method + " " + rw;
+        emitResult(label, {{"iops", iops}, {"mibps", iops * job.bs / 1048576.0}, {"qd", double(r.depth)},
+                           {"p50_ns", double(r.lat.percentile(50))}, {"p99_ns", double(r.lat.percentile(99))},
+                           {"p999_ns", double(r.lat.percentile(99.9))}, {"flush_ms", flushMs},
+                           {"major_faults", double(f.major)}, {"minor_faults", double(f.minor)}});
+        emitHistogram(label, r.lat);
+        if (r.errors) rc = 1;
+    };
+
+    // mmap; MAP_POPULATE and the madvise call happen before the clock starts
+    dropCaches(t.fd);
+    {
+        FaultCounts f0 = faultCounts();
+        const int prot = PROT_READ | (writes ? PROT_WRITE : 0);
+        void* m = mmap(nullptr, span, prot, MAP_SHARED | (a.flag("populate") ? MAP_POPULATE : 0), t.fd, 0);
+        if (m == MAP_FAILED) { std::printf("error: mmap: %s\n", std::strerror(errno)); return 1; }
+        if (madvise(m, span, advice.at(advise)) != 0)
+            std::printf("note: madvise(%s): %s\n", advise.c_str(), std::strerror(errno));
+        auto r = std::make_unique<DiskStepResult>();
+        runMmapStep(static_cast<uint8_t*>(m), bufs.ptrs[0], job, span, runtime, rng, "mmap " + rw, *r);
+        const uint64_t s0 = monoNs();
+        if (writes) msync(m, span, MS_SYNC);
+        const double flushMs = (monoNs() - s0) / 1e6;
+        munmap(m, span);
+        FaultCounts f1 = faultCounts();
+        report("mmap", *r, flushMs, {f1.major - f0.major, f1.minor - f0.minor});
+    }
+    if (writes) forgetPreparedFile(path);   // overwritten with repeated buffers: no longer the prepared data
+    if (!a.flag("compare")) return rc;
+
+    for (const char* engine : {"psync", "io_uring"}) {
+        if (g_engineStop) break;
+        dropCaches(t.fd);
+        FaultCounts f0 = faultCounts();
+        auto io = makeIoBackend(engine, t.fd, bufs.ptrs, job.bs, false);
+        const std::string method = std::string(engine) == "psync" ? "pread/pwrite" : io->name();
+        auto r = std::make_unique<DiskStepResult>();
+        runDiskStep(*io, std::min(depth, io->maxDepth()), job, span, runtime, rng, method + " " + rw, *r);
+        const uint64_t s0 = monoNs();
+        if (writes) fdatasync(t.fd);
+        const double flushMs = (monoNs() - s0) / 1e6;
+        FaultCounts f1 = faultCounts();
+        report(method, *r, flushMs, {f1.major - f0.major, f1.minor - f0.minor});
+    }
+    return rc;
+}
+
+// --- Local iperf3 server ---
+
+// IPv4 addresses of the interfaces that are up, loopback first.
+static std::vector<std::pair<std::string,std::string>> listInterfaceAddrs() {
+    std::vector<std::pair<std::string,std::string>> out;
+    struct ifaddrs* ifs = nullptr;
+    if (getifaddrs(&ifs) != 0) return out;
+    for (auto* i = ifs; i; i = i->ifa_next) {
+        if (!i->ifa_addr || i->ifa_addr->sa_family != AF_INET || !(i->ifa_flags & IFF_UP)) continue;
+        char addr[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &reinterpret_cast<sockaddr_in*>(i->ifa_addr)->sin_addr, addr, sizeof addr);
+        auto entry = std::make_pair(std::string(i->ifa_name), std::string(addr));
+        if (i->ifa_flags & IFF_LOOPBACK) out.insert(out.begin(), entry);
+        else out.push_back(entry);
+    }
+    freeifaddrs(ifs);
+    return out;
+}
+
+// A TCP socket in network namespace `netns` ("" = ours). A socket stays in
+// the namespace it was created in, so only its creation needs the switch.
+static int netnsSocket(const std::string& netns) {
+    if (netns.empty()) return socket(AF_INET, SOCK_STREAM, 0);
+    const int self = open("/proc/self/ns/net", O_RDONLY|O_CLOEXEC);
+    const int target = open(("/run/netns/" + netns).c_str(), O_RDONLY|O_CLOEXEC);
+    int s = -1;
+    if (self >= 0 && target >= 0 && setns(target, CLONE_NEWNET) == 0) {
+        s = socket(AF_INET, SOCK_STREAM|SOCK_CLOEXEC, 0);
+        if (setns(self, CLONE_NEWNET) != 0) { std::printf("error: cannot leave netns %s\n", netns.c_str()); _exit(1); }
+    }
+    if (self >= 0) close(self);
+    if (target >= 0) close(target);
+    return s;
+}
+
+// Lets the kernel pick a free TCP port on `addr` (inside `netns` if given).
+static int ephemeralPort(const std::string& addr, const std::string& netns = "") {
+    int s = netnsSocket(netns);
+    if (s < 0) return -1;
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    socklen_t len = sizeof sa;
+    int port = -1;
+    if (inet_pton(AF_INET, addr.c_str(), &sa.sin_addr) == 1 &&
+        bind(s, reinterpret_cast<sockaddr*>(&sa), sizeof sa) == 0 &&
+        getsockname(s, reinterpret_cast<sockaddr*>(&sa), &len) == 0)
+        port = ntohs(sa.sin_port);
+    close(s);
+    return port;
+}
+
+// Runs argv (prefixed with "ip netns exec NS" when a namespace is given) as a
+// child that dies with us.
+static pid_t spawn(std::vector<std::string> args, const std::string& netns, bool quiet) {
+    if (!netns.empty()) args.insert(args.begin(), {"ip", "netns", "exec", netns});
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+    if (quiet) {
+        int dn = open("/dev/null", O_WRONLY);
+        if (dn >= 0) { dup2(dn, STDOUT_FILENO); close(dn); }
+    }
+    std::vector<char*> argv;
+    for (auto& s : args) argv.push_back(s.data());
+    argv.push_back(nullptr);
+    execvp(argv[0], argv.data());
+    std::fprintf(stderr, "error: %s: %s\n", argv[0], std::strerror(errno));
+    _exit(127);
+}
+
+// waitpid() that forwards a stop request to the child.
+static int waitChild(pid_t pid) {
+    int status = 0;
+    bool forwarded = false;
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR) return -1;
+        if (g_engineStop && !forwarded) { kill(pid, SIGTERM); forwarded = true; }
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+
+// hst --engine iperf-local [--bind 127.0.0.1] [--netns NS] [-- client args...]
+// Starts "iperf3 -s" on an ephemeral port of --bind (inside --netns if given),
+// runs "iperf3 -c" against it with the trailing arguments, then stops the
+// server. The exit code is the client's. In a namespace the port pick and the
+// readiness probe use sockets created inside it, and loopback is brought up.
+static int engineIperfLocal(const EngineArgs& a) {
+    const std::string bind = a.str("bind", "127.0.0.1");
+    const std::string netns = a.str("netns");
+    if (!netns.empty() && bind.rfind("127.", 0) == 0) waitChild(spawn({"ip", "-n", netns, "link", "set", "lo", "up"}, "", true));
+    const int port = ephemeralPort(bind, netns);
+    if (port <= 0) {
+        std::printf("error: cannot bind %s%s\n", bind.c_str(), netns.empty() ? "" : (" in netns " + netns).c_str());
+        return 1;
+    }
+    const std::string ps = std::to_string(port);
+
+    std::printf("local iperf3 server on %s:%s%s\n", bind.c_str(), ps.c_str(),
+                netns.empty() ? "" : (" in netns " + netns).c_str());
+    pid_t server = spawn({"iperf3", "-s", "-B", bind, "-p", ps}, netns, true);
+    if (server < 0) { std::printf("error: fork: %s\n", std::strerror(errno)); return 1; }
+
+    // Wait for the listener
+    bool ready = false;
+    for (int i = 0; i < 100 && !ready && !g_engineStop; ++i) {
+        int s = netnsSocket(netns);
+        sockaddr_in sa{};
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(uint16_t(port));
+        inet_pton(AF_INET, bind.c_str(), &sa.sin_addr);
+        ready = connect(s, reinterpret_cast<sockaddr*>(&sa), sizeof sa) == 0;
+        close(s);
+        if (!ready) {
+            if (waitpid(server, nullptr, WNOHANG) == server) { std::printf("error: iperf3 server exited\n"); return 1; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    }
+    if (!ready && !g_engineStop) std::printf("warning: iperf3 server not accepting on %s:%s after 5 s\n", bind.c_str(), ps.c_str());
+
+    int rc = 1;
+    if (!g_engineStop) {
+        std::vector<std::string> client {"iperf3", "-c", bind, "-p", ps};
+        for (char* arg : a.rest) client.push_back(arg);
+        pid_t pid = spawn(client, netns, false);
+        rc = pid < 0 ? 1 : waitChild(pid);
+    }
+    kill(server, SIGTERM);
+    waitChild(server);
+    std::printf("local iperf3 server stopped\n");
+    return rc;
+}
+
+// --- Native TCP throughput ---
+
+// CPU cycles spent by the calling thread: the hardware counter (user + kernel)
+// when perf allows it, otherwise thread CPU time at the nominal clock.
+class ThreadCycles {
+public:
+    ThreadCycles() {
+        perf_event_attr pe{};
+        pe.size = sizeof pe;
+        pe.type = PERF_TYPE_HARDWARE;
+        pe.config = PERF_COUNT_HW_CPU_CYCLES;
+        pe.exclude_hv = 1;
+        m_fd = int(syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0));
+        m_cpu0 = threadCpuNs();
+    }
+    ~ThreadCycles() { if (m_fd >= 0) close(m_fd); }
+    bool counted() const { return m_fd >= 0; }
+    double cycles() const {
+        uint64_t v = 0;
+        if (m_fd >= 0 && read(m_fd, &v, sizeof v) == ssize_t(sizeof v)) return double(v);
+        return (threadCpuNs() - m_cpu0) * nominalGHz();
+    }
+    double cpuSeconds() const { return (threadCpuNs() - m_cpu0) / 1e9; }
+
+    static double nominalGHz() {
+        static const double ghz = [] {
+            for (const char* f : {"/sys/devices/system/cpu/cpu0/cpufreq/base_frequency",
+                                  "/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq"}) {
+                double khz = std::atof(readSysfs(f).c_str());
+                if (khz > 0) return khz / 1e6;
+            }
+            std::ifstream in("/proc/cpuinfo");
+            for (std::string line; std::getline(in, line); )
+                if (line.rfind("cpu MHz", 0) == 0) return std::atof(line.substr(line.find(':') + 1).c_str()) / 1e3;
+            return 1.0;
+        }();
+        return ghz;
+    }
+
+private:
+    static uint64_t threadCpuNs() {
+        timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+    }
+    int m_fd = -1;
+    uint64_t m_cpu0 = 0;
+};
+
+enum class SendPath { Write, Sendfile, Splice, ZeroCopy };
+
+static const char* sendPathName(SendPath p) {
+    switch (p) {
+        case SendPath::Write:    return "write";
+        case SendPath::Sendfile: return "sendfile";
+        case SendPath::Splice:   return "splice";
+        case SendPath::ZeroCopy: return "zerocopy";
+    }
+    return "?";
+}
+
+struct TcpStream {
+    int fd = -1;
+    off_t fileOff = 0;           // sendfile / splice source position
+    int pipe[2] = {-1, -1};      // splice: file -> pipe -> socket
+    size_t inPipe = 0;
+    uint64_t zcSent = 0, zcDone = 0, zcCopied = 0;
+    ~TcpStream() {
+        if (fd >= 0) close(fd);
+        if (pipe[0] >= 0) { close(pipe[0]); close(pipe[1]); }
+    }
+};
+
+struct TcpSideStats {
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> cyclesX10{0}, cpuUs{0};   // summed over worker threads at exit
+    std::atomic<bool> counted{true};
+};
+
+// Completions of MSG_ZEROCOPY sends arrive on the error queue; until reaped
+// they pin socket memory. Ranges flagged COPIED fell back to a copy (always
+// the case on loopback).
+static void reapZeroCopy(TcpStream& s) {
+    char control[128];
+    for (;;) {
+        msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof control;
+        if (recvmsg(s.fd, &msg, MSG_ERRQUEUE) < 0) return;
+        for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm)) {
+            auto* ee = reinterpret_cast<sock_extended_err*>(CMSG_DATA(cm));
+            if (ee->ee_errno != 0 || ee->ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+            const uint64_t n = uint64_t(ee->ee_data - ee->ee_info) + 1;
+            s.zcDone += n;
+            if (ee->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) s.zcCopied += n;
+        }
+    }
+}
+
+// One send on a non-blocking socket; returns bytes queued, 0 on EAGAIN, -1 on error.
+static ssize_t tcpSendOnce(TcpStream& s, SendPath path, const void* buf, size_t len, int srcFd, off_t srcSize) {
+    ssize_t n = -1;
+    switch (path) {
+        case SendPath::Write:
+            n = write(s.fd, buf, len);
+            break;
+        case SendPath::ZeroCopy:
+            n = send(s.fd, buf, len, MSG_ZEROCOPY);
+            if (n > 0) ++s.zcSent;
+            if (n < 0 && errno == ENOBUFS) { reapZeroCopy(s); errno = EAGAIN; }
+            break;
+        case SendPath::Sendfile:
+            if (s.fileOff >= srcSize) s.fileOff = 0;
+            n = sendfile(s.fd, srcFd, &s.fileOff, std::min<size_t>(len, size_t(srcSize - s.fileOff)));
+            break;
+        case SendPath::Splice:
+            if (s.inPipe == 0) {
+                if (s.fileOff >= srcSize) s.fileOff = 0;
+                ssize_t in = splice(srcFd, &s.fileOff, s.pipe[1], nullptr,
+                                    std::min<size_t>(len, size_t(srcSize - s.fileOff)), SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+                if (in <= 0) return in < 0 && errno == EAGAIN ? 0 : -1;
+                s.inPipe = size_t(in);
+            }
+            n = splice(s.pipe[0], nullptr, s.fd, nullptr, s.inPipe, SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE);
+            if (n > 0) s.inPipe -= size_t(n);
+            break;
+    }
+    if (n < 0) return errno == EAGAIN ? 0 : -1;
+    return n;
+}
+
+// Level-triggered epoll loop: a worker thread owns a subset of the streams and
+// either keeps them all writable-full (sender) or drains them (receiver).
+static void tcpWorker(std::vector<TcpStream*> streams, bool sender, SendPath path, size_t msg, int srcFd,
+                      off_t srcSize, const std::atomic<bool>& running, TcpSideStats& st) {
+    ThreadCycles cyc;
+    int ep = epoll_create1(0);
+    for (auto* s : streams) {
+        epoll_event ev{};
+        ev.events = sender ? EPOLLOUT : EPOLLIN;
+        ev.data.ptr = s;
+        epoll_ctl(ep, EPOLL_CTL_ADD, s->fd, &ev);
+    }
+    void* buf = nullptr;
+    if (posix_memalign(&buf, 4096, msg) != 0) buf = nullptr;
+    if (buf) std::memset(buf, 0x5a, msg);
+    size_t open = streams.size();
+    epoll_event evs[64];
+    while (buf && open > 0 && (!sender || running)) {
+        const int n = epoll_wait(ep, evs, 64, 100);
+        for (int i = 0; i < n; ++i) {
+            auto* s = static_cast<TcpStream*>(evs[i].data.ptr);
+            if (sender) {
+                if (path == SendPath::ZeroCopy && (evs[i].events & EPOLLERR)) reapZeroCopy(*s);
+                for (int burst = 0; burst < 16; ++burst) {
+                    ssize_t w = tcpSendOnce(*s, path, buf, msg, srcFd, srcSize);
+                    if (w <= 0) {
+                        if (w < 0) { epoll_ctl(ep, EPOLL_CTL_DEL, s->fd, nullptr); --open; }
+                        break;
+                    }
+                    st.bytes += uint64_t(w);
+                }
+            } else {
+                for (int burst = 0; burst < 16; ++burst) {
+                    ssize_t r = recv(s->fd, buf, msg, 0);
+                    if (r > 0) { st.bytes += uint64_t(r); continue; }
+                    if (r == 0 || errno != EAGAIN) { epoll_ctl(ep, EPOLL_CTL_DEL, s->fd, nullptr); --open; }
+                    break;
+                }
+            }
+        }
+    }
+    if (sender && path == SendPath::ZeroCopy) {
+        // Give outstanding completions a moment so the copied/zero-copy split is complete
+        for (int i = 0; i < 50; ++i) {
+            bool pending = false;
+            for (auto* s : streams) { reapZeroCopy(*s); pending |= s->zcDone < s->zcSent; }
+            if (!pending) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    std::free(buf);
+    close(ep);
+    st.cyclesX10 += uint64_t(cyc.cycles() * 10);
+    st.cpuUs += uint64_t(cyc.cpuSeconds() * 1e6);
+    if (!cyc.counted()) st.counted = false;
+}
+
+static int tcpListen(const std::string& addr, int port, int backlog) {
+    int l = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(l, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(uint16_t(port));
+    inet_pton(AF_INET, addr.c_str(), &sa.sin_addr);
+    if (bind(l, reinterpret_cast<sockaddr*>(&sa), sizeof sa) != 0 || listen(l, backlog) != 0) { close(l); return -1; }
+    return l;
+}
+
+static int tcpConnect(const std::string& host, int port) {
+    int s = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(uint16_t(port));
+    if (inet_pton(AF_INET, host.c_str(), &sa.sin_addr) != 1 ||
+        connect(s, reinterpret_cast<sockaddr*>(&sa), sizeof sa) != 0) { close(s); return -1; }
+    return s;
+}
+
+static void setNonBlocking(int fd) { fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+// hst --engine tcp [--role both|client|server] [--host 127.0.0.1] [--port 5301]
+//     [--streams 8] [--threads N] [--path write|sendfile|splice|zerocopy|all]
+//     [--msg 128k] [--runtime 10]
+// "both" runs sender and receiver in this process over --host; "client" only
+// sends to a remote "server", which receives until stopped. Each send path
+// runs for --runtime seconds on fresh connections and reports Gbit/s and CPU
+// cycles per byte for the sending and receiving threads.
+static int engineTcp(const EngineArgs& a) {
+    const std::string role = a.str("role", "both");
+    const std::string host = a.str("host", "127.0.0.1");
+    const int port = int(a.num("port", 5301));
+    const unsigned streams = unsigned(std::clamp(a.num("streams", 8), 1L, 1024L));
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned threads = unsigned(std::clamp(a.num("threads", long(std::max(1u, hw / 2))), 1L, long(streams)));
+    const size_t msg = size_t(std::clamp<uint64_t>(a.bytes("msg", 128 << 10), 1024, 16ull << 20));
+    const double runtime = std::max(1L, a.num("runtime", 10));
+    if (role != "both" && role != "client" && role != "server") { std::printf("error: bad --role\n"); return 2; }
+
+    std::vector<SendPath> paths;
+    const std::string pathArg = a.str("path", "all");
+    for (SendPath p : {SendPath::Write, SendPath::Sendfile, SendPath::Splice, SendPath::ZeroCopy})
+        if (pathArg == "all" || pathArg == sendPathName(p)) paths.push_back(p);
+    if (paths.empty()) { std::printf("error: bad --path\n"); return 2; }
+
+    // Server-only: accept and drain until stopped, reporting once a second
+    if (role == "server") {
+        int l = tcpListen(host, port, 1024);
+        if (l < 0) { std::printf("error: listen %s:%d: %s\n", host.c_str(), port, std::strerror(errno)); return 1; }
+        std::printf("tcp server on %s:%d\n", host.c_str(), port);
+        std::atomic<uint64_t> total{0};
+        std::vector<std::thread> pool;
+        // Open connections, so a stop can shut them down and join their receivers;
+        // a receiver closes its own socket (and clears the slot) when the peer goes away
+        std::mutex connMx;
+        std::vector<int> conns;
+        std::thread acceptor([&] {
+            while (!g_engineStop) {
+                int c = accept(l, nullptr, nullptr);
+                if (c < 0) {
+                    if (errno == EINTR || errno == ECONNABORTED) continue;
+                    if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));   // out of descriptors: back off
+                        continue;
+                    }
+                    break;   // listener shut down
+                }
+                size_t slot;
+                {
+                    std::lock_guard<std::mutex> lk(connMx);
+                    slot = conns.size();
+                    conns.push_back(c);
+                }
+                pool.emplace_back([c, slot, msg, &total, &connMx, &conns] {
+                    std::vector<char> buf(msg);
+                    for (ssize_t r; (r = recv(c, buf.data(), buf.size(), 0)) > 0; ) total += uint64_t(r);
+                    std::lock_guard<std::mutex> lk(connMx);
+                    close(c);
+                    conns[slot] = -1;
+                });
+            }
+        });
+        uint64_t last = 0;
+        while (!g_engineStop) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            const uint64_t now = total;
+            std::printf("  %8.2f Gbit/s\n", (now - last) * 8 / 1e9);
+            last = now;
+        }
+        shutdown(l, SHUT_RDWR);
+        acceptor.join();
+        close(l);
+        {
+            std::lock_guard<std::mutex> lk(connMx);
+            for (int c : conns) if (c >= 0) shutdown(c, SHUT_RDWR);
+        }
+        for (auto& t : pool) t.join();
+        return 0;
+    }
+
+    // Source for sendfile/splice: a memory-backed file of random bytes
+    const off_t srcSize = off_t(std::max<size_t>(msg, 4u << 20));
+    int src = int(syscall(__NR_memfd_create, "hst-tcp", 0));
+    if (src < 0 || ftruncate(src, srcSize) != 0) { std::printf("error: memfd: %s\n", std::strerror(errno)); return 1; }
+    {
+        std::mt19937_64 rng(monoNs());
+        std::vector<uint64_t> chunk(65536 / 8);
+        for (off_t off = 0; off < srcSize; off += 65536) {
+            for (auto& w : chunk) w = rng();
+            if (pwrite(src, chunk.data(), 65536, off) != 65536) break;
+        }
+    }
+
+    // A peer going away must show up as EPIPE, not kill the engine
+    struct sigaction ignore{}, oldPipe{};
+    ignore.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &ignore, &oldPipe);
+
+    std::printf("tcp: %s %s:%d  streams %u  threads %u/side  msg %s  nominal %.2f GHz\n", role.c_str(),
+                host.c_str(), port, streams, threads, fmtSize(msg).c_str(), ThreadCycles::nominalGHz());
+    std::printf("%-10s %10s %14s %14s %10s %10s %12s\n", "path", "Gbit/s", "tx cycles/B", "rx cycles/B",
+                "tx cpu-s", "rx cpu-s", "zc copied");
+    int rc = 0;
+    bool estimated = false;
+    for (size_t pi = 0; pi < paths.size() && !g_engineStop; ++pi) {
+        const SendPath path = paths[pi];
+        int l = -1;
+        if (role == "both" && (l = tcpListen(host, port, int(streams))) < 0) {
+            std::printf("error: listen %s:%d: %s\n", host.c_str(), port, std::strerror(errno));
+            return 1;
+        }
+        std::vector<std::unique_ptr<TcpStream>> tx, rx;
+        bool ok = true;
+        for (unsigned i = 0; i < streams && ok; ++i) {
+            auto s = std::make_unique<TcpStream>();
+            s->fd = tcpConnect(host, port);
+            ok = s->fd >= 0;
+            if (!ok) { std::printf("error: connect %s:%d: %s\n", host.c_str(), port, std::strerror(errno)); break; }
+            if (path == SendPath::ZeroCopy) {
+                int one = 1;
+                if (setsockopt(s->fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof one) != 0 && i == 0)
+                    std::printf("note: SO_ZEROCOPY: %s\n", std::strerror(errno));
+            }
+            if (path == SendPath::Splice) {
+                ok = pipe2(s->pipe, O_NONBLOCK) == 0;
+                if (ok) fcntl(s->pipe[1], F_SETPIPE_SZ, int(std::min<size_t>(msg, 1u << 20)));
+            }
+            setNonBlocking(s->fd);
+            s->fileOff = off_t((uint64_t(i) * 65536) % uint64_t(srcSize));
+            tx.push_back(std::move(s));
+            if (l >= 0) {
+                auto r = std::make_unique<TcpStream>();
+                r->fd = accept(l, nullptr, nullptr);
+                setNonBlocking(r->fd);
+                rx.push_back(std::move(r));
+            }
+        }
+        if (l >= 0) close(l);
+        if (!ok) { rc = 1; break; }
+
+        std::atomic<bool> running{true};
+        TcpSideStats txs, rxs;
+        std::vector<std::thread> senders, receivers;
+        auto spread = [&](std::vector<std::unique_ptr<TcpStream>>& v, bool sender, TcpSideStats& st,
+                          std::vector<std::thread>& pool) {
+            for (unsigned t = 0; t < threads; ++t) {
+                std::vector<TcpStream*> mine;
+                for (size_t i = t; i < v.size(); i += threads) mine.push_back(v[i].get());
+                if (!mine.empty())
+                    pool.emplace_back(tcpWorker, mine, sender, path, msg, src, srcSize, std::cref(running), std::ref(st));
+            }
+        };
+        spread(rx, false, rxs, receivers);
+        spread(tx, true, txs, senders);
+
+        TcpSideStats& measured = role == "both" ? rxs : txs;
+        const uint64_t t0 = monoNs();
+        uint64_t last = 0, lastT = t0;
+        while (!g_engineStop && monoNs() - t0 < uint64_t(runtime * 1e9)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            const uint64_t now = monoNs(), b = measured.bytes;
+            std::printf("  %-8s %5.1fs %8.2f Gbit/s\n", sendPathName(path), (now - t0) / 1e9,
+                        (b - last) * 8 / ((now - lastT) / 1e9) / 1e9);
+            emitProgress((pi + std::min(1.0, (now - t0) / (runtime * 1e9))) / paths.size());
+            last = b; lastT = now;
+        }
+        const double secs = (monoNs() - t0) / 1e9;
+        const uint64_t bytes = measured.bytes;
+        running = false;
+        for (auto& t : senders) t.join();
+        for (auto& s : tx) shutdown(s->fd, SHUT_WR);   // receivers see EOF and exit
+        for (auto& t : receivers) t.join();
+
+        uint64_t zcSent = 0, zcCopied = 0;
+        for (const auto& s : tx) { zcSent += s->zcDone; zcCopied += s->zcCopied; }
+        const double gbps = bytes * 8 / secs / 1e9;
+        const double txCpb = txs.bytes ? txs.cyclesX10 / 10.0 / double(txs.bytes) : 0;
+        const double rxCpb = rxs.bytes ? rxs.cyclesX10 / 10.0 / double(rxs.bytes) : 0;
+        char zc[32] = "-", rxc[32] = "-";
+        if (path == SendPath::ZeroCopy && zcSent) std::snprintf(zc, sizeof zc, "%.0f%%", 100.0 * zcCopied / zcSent);
+        if (role == "both") std::snprintf(rxc, sizeof rxc, "%.3f", rxCpb);
+        std::printf("%-10s %10.2f %14.3f %14s %10.2f %10.2f %12s\n", sendPathName(path), gbps, txCpb, rxc,
+                    txs.cpuUs / 1e6, rxs.cpuUs / 1e6, zc);
+        emitResult(std::string("tcp ") + sendPathName(path),
+                   {{"gbps", gbps}, {"streams", double(streams)}, {"tx_cycles_per_byte", txCpb},
+                    {"rx_cycles_per_byte", rxCpb}, {"tx_cpu_s", txs.cpuUs / 1e6}, {"rx_cpu_s", rxs.cpuUs / 1e6},
+                    {"cycles_measured", txs.counted && rxs.counted ? 1.0 : 0.0},
+                    {"zerocopy_copied_pct", zcSent ? 100.0 * zcCopied / zcSent : 0.0}});
+        estimated |= !txs.counted || !rxs.counted;
+    }
+    if (estimated) std::printf("note: no cycle counter (perf_event_paranoid?); cycles = CPU time x nominal clock\n");
+    close(src);
+    sigaction(SIGPIPE, &oldPipe, nullptr);
+    return rc;
+}
+
+// --- Native UDP packet rate ---
+
+// One protocol's counters from /proc/net/snmp or /proc/net/netstat, where
+// each protocol is a header line of names followed by a line of values.
+static std::map<std::string, uint64_t> readNetStats(const char* file, const std::string& proto) {
+    std::map<std::string, uint64_t> out;
+    std::ifstream in(file);
+    const std::string prefix = proto + ":";
+    for (std::string names, values; std::getline(in, names); ) {
+        if (names.rfind(prefix, 0) != 0 || !std::getline(in, values)) continue;
+        std::istringstream n(names.substr(prefix.size())), v(values.substr(prefix.size()));
+        std::string key;
+        uint64_t val;
+        while (n >> key && v >> val) out[key] = val;
+        break;
+    }
+    return out;
+}
+
+// hst --engine udp [--role both|client|server] [--host 127.0.0.1] [--port 5302]
+//     [--sizes 64,128,256,512,1024,1472] [--threads N] [--batch 64] [--runtime 10]
+// Packet rate per UDP payload size (1472 fills a 1500-byte MTU). Each sender
+// thread has its own connected socket and pushes batches with sendmmsg();
+// receivers are SO_REUSEPORT sockets draining with recvmmsg(), so the kernel
+// spreads flows across them by source port. Loss is sent minus received;
+// the kernel's reasons come from the Udp counters in /proc/net/snmp.
+static int engineUdp(const EngineArgs& a) {
+    const std::string role = a.str("role", "both");
+    const std::string host = a.str("host", "127.0.0.1");
+    const int port = int(a.num("port", 5302));
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned threads = unsigned(std::clamp(a.num("threads", long(std::max(1u, hw / 2))), 1L, 256L));
+    const unsigned batch = unsigned(std::clamp(a.num("batch", 64), 1L, 1024L));
+    const double runtime = std::max(1L, a.num("runtime", 10));
+    if (role != "both" && role != "client" && role != "server") { std::printf("error: bad --role\n"); return 2; }
+    std::vector<size_t> sizes;
+    for (std::string rest = a.str("sizes", "64,128,256,512,1024,1472"); !rest.empty(); ) {
+        const size_t comma = rest.find(',');
+        const long v = std::atol(rest.substr(0, comma).c_str());
+        if (v > 0 && v <= 65507) sizes.push_back(size_t(v));
+        rest = comma == std::string::npos ? "" : rest.substr(comma + 1);
+    }
+    if (sizes.empty()) { std::printf("error: bad --sizes\n"); return 2; }
+
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(uint16_t(port));
+    if (inet_pton(AF_INET, host.c_str(), &sa.sin_addr) != 1) { std::printf("error: bad --host\n"); return 2; }
+
+    // Receivers: one SO_REUSEPORT socket each, 100 ms timeout to notice the stop flag
+    std::atomic<bool> receiving{true};
+    std::atomic<uint64_t> rxPackets{0}, rxBytes{0};
+    std::vector<std::thread> receivers;
+    if (role != "client") {
+        for (unsigned t = 0; t < threads; ++t) {
+            int s = socket(AF_INET, SOCK_DGRAM, 0);
+            int one = 1, rcvbuf = 4 << 20;
+            timeval tv{0, 100000};
+            setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &one, sizeof one);
+            setsockopt(s, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof rcvbuf);
+            setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+            if (bind(s, reinterpret_cast<sockaddr*>(&sa), sizeof sa) != 0) {
+                std::printf("error: bind %s:%d: %s\n", host.c_str(), port, std::strerror(errno));
+                close(s);
+                receiving = false;
+                for (auto& th : receivers) th.join();
+                return 1;
+            }
+            receivers.emplace_back([s, batch, &receiving, &rxPackets, &rxBytes] {
+                const size_t slot = 65536;
+                std::vector<char> bufs(size_t(batch) * slot);
+                std::vector<iovec> iov(batch);
+                std::vector<mmsghdr> msgs(batch);
+                for (unsigned i = 0; i < batch; ++i) {
+                    iov[i] = {bufs.data() + i * slot, slot};
+                    msgs[i].msg_hdr.msg_iov = &iov[i];
+                    msgs[i].msg_hdr.msg_iovlen = 1;
+                }
+                while (receiving) {
+                    int n = recvmmsg(s, msgs.data(), batch, MSG_WAITFORONE, nullptr);
+                    if (n <= 0) continue;
+                    uint64_t b = 0;
+                    for (int i = 0; i < n; ++i) b += msgs[i].msg_len;
+                    rxPackets += uint64_t(n);
+                    rxBytes += b;
+                }
+                close(s);
+            });
+        }
+    }
+
+    if (role == "server") {
+        std::printf("udp server on %s:%d  %u receiver(s)\n", host.c_str(), port, threads);
+        uint64_t last = 0;
+        while (!g_engineStop) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            const uint64_t now = rxPackets;
+            std::printf("  %12.0f pkt/s\n", double(now - last));
+            last = now;
+        }
+        receiving = false;
+        for (auto& th : receivers) th.join();
+        return 0;
+    }
+
+    std::printf("udp: %s %s:%d  threads %u  batch %u  runtime %.0f s per size\n", role.c_str(), host.c_str(), port,
+                threads, batch, runtime);
+    std::printf("%6s %14s %14s %10s %8s %12s %12s %12s\n", "size", "tx pkt/s", "rx pkt/s", "rx Gbit/s", "loss%",
+                "RcvbufErrs", "SndbufErrs", "InErrors");
+    for (size_t si = 0; si < sizes.size() && !g_engineStop; ++si) {
+        const size_t size = sizes[si];
+        const auto snmp0 = readNetStats("/proc/net/snmp", "Udp");
+        const uint64_t rxp0 = rxPackets, rxb0 = rxBytes;
+        std::atomic<bool> sending{true};
+        std::atomic<uint64_t> txPackets{0};
+        std::vector<std::thread> senders;
+        for (unsigned t = 0; t < threads; ++t) {
+            senders.emplace_back([&, size] {
+                int s = socket(AF_INET, SOCK_DGRAM, 0);
+                if (connect(s, reinterpret_cast<const sockaddr*>(&sa), sizeof sa) != 0) { close(s); return; }
+                std::vector<char> payload(size, 'u');
+                iovec iov{payload.data(), size};
+                std::vector<mmsghdr> msgs(batch);
+                for (auto& m : msgs) { m.msg_hdr.msg_iov = &iov; m.msg_hdr.msg_iovlen = 1; }
+                uint64_t sent = 0;
+                while (sending) {
+                    int n = sendmmsg(s, msgs.data(), batch, 0);
+                    if (n > 0) sent += uint64_t(n);
+                    else if (errno != ENOBUFS && errno != EAGAIN && errno != ECONNREFUSED) break;
+                }
+                txPackets += sent;
+                close(s);
+            });
+        }
+        const uint64_t t0 = monoNs();
+        while (!g_engineStop && monoNs() - t0 < uint64_t(runtime * 1e9)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            emitProgress((si + std::min(1.0, (monoNs() - t0) / (runtime * 1e9))) / sizes.size());
+        }
+        sending = false;
+        for (auto& th : senders) th.join();
+        const double secs = (monoNs() - t0) / 1e9;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));   // let receivers drain
+        auto snmp1 = readNetStats("/proc/net/snmp", "Udp");
+        auto delta = [&](const char* k) {
+            auto before = snmp0.find(k);
+            return double(snmp1[k] - (before == snmp0.end() ? 0 : before->second));
+        };
+
+        const double tx = double(txPackets), rx = double(rxPackets - rxp0);
+        const double txPps = tx / secs, rxPps = role == "both" ? rx / secs : 0;
+        const double rxGbps = role == "both" ? (rxBytes - rxb0) * 8 / secs / 1e9 : 0;
+        const double loss = role == "both" && tx > 0 ? std::max(0.0, 100.0 * (tx - rx) / tx) : 0;
+        std::printf("%6zu %14.0f %14.0f %10.2f %8.2f %12.0f %12.0f %12.0f\n", size, txPps, rxPps, rxGbps, loss,
+                    delta("RcvbufErrors"), delta("SndbufErrors"), delta("InErrors"));
+        emitResult("udp " + std::to_string(size), {{"size", double(size)}, {"tx_pps", txPps}, {"rx_pps", rxPps},
+                   {"rx_gbps", rxGbps}, {"loss_pct", loss}, {"rcvbuf_errors", delta("RcvbufErrors")},
+                   {"sndbuf_errors", delta("SndbufErrors")}, {"in_errors", delta("InErrors")}});
+    }
+    receiving = false;
+    for (auto& th : receivers) th.join();
+    return 0;
+}
+
+// --- Request/response latency ---
+
+static void setBusyPoll(int fd, int usec) {
+    if (usec > 0 && setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof usec) != 0) {
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true)) std::printf("note: SO_BUSY_POLL: %s (raising it needs CAP_NET_ADMIN)\n", std::strerror(errno));
+    }
+}
+
+static bool sendAll(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+        if (w <= 0) { if (w < 0 && errno == EINTR) continue; return false; }
+        p += w; n -= size_t(w);
+    }
+    return true;
 }
 
-// -----------------------------
-// DonutGauge (compact semicircle)
-// -----------------------------
-
-class DonutGauge : public QWidget {
-    Q_OBJECT
+// Echo side: every TCP connection gets its own thread; UDP datagrams are
+// answered by `udpThreads` threads sharing one socket.
+class EchoServer {
 public:
-    explicit DonutGauge(QWidget* parent=nullptr)
-        : QWidget(parent)
-    {
-        setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
-        setFixedSize(200, 160);
+    ~EchoServer() { stop(); }
+
+    bool start(const std::string& host, int port, unsigned udpThreads, int busyPoll, std::string& err) {
+        m_busyPoll = busyPoll;
+        m_tcp = tcpListen(host, port, 1024);
+        if (m_tcp < 0) { err = "listen: " + std::string(std::strerror(errno)); return false; }
+        m_udp = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in sa{};
+        sa.sin_family = AF_INET;
+        sa.sin_port = htons(uint16_t(port));
+        inet_pton(AF_INET, host.c_str(), &sa.sin_addr);
+        timeval tv{0, 100000};
+        setsockopt(m_udp, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+        setBusyPoll(m_udp, busyPoll);
+        if (bind(m_udp, reinterpret_cast<sockaddr*>(&sa), sizeof sa) != 0) {
+            err = "bind udp: " + std::string(std::strerror(errno));
+            return false;
+        }
+        m_threads.emplace_back([this] { acceptLoop(); });
+        for (unsigned i = 0; i < std::max(1u, udpThreads); ++i) m_threads.emplace_back([this] { udpLoop(); });
+        return true;
     }
 
-    QSize sizeHint() const override { return {200,160}; }
+    void stop() {
+        if (m_stop.exchange(true)) return;
+        if (m_tcp >= 0) shutdown(m_tcp, SHUT_RDWR);
+        for (auto& t : m_threads) t.join();
+        std::lock_guard<std::mutex> lk(m_mu);
+        for (int c : m_conns) shutdown(c, SHUT_RDWR);
+        for (auto& t : m_connThreads) t.join();
+        if (m_tcp >= 0) close(m_tcp);
+        if (m_udp >= 0) close(m_udp);
+    }
 
-    void setLabel(const QString& t) { m_label = t; update(); }
-    void setArcColor(const QColor& c) { m_arc = c; update(); }
-    void setTrackColor(const QColor& c) { m_track = c; update(); }
-    void setTextColor(const QColor& c) { m_text = c; update(); }
-    void setCaptionColor(const QColor& c) { m_caption = c; update(); }
-    void setCaptionColorCoded(bool on) { m_captionColorCoded = on; update(); }
+private:
+    void acceptLoop() {
+        while (!m_stop) {
+            int c = accept(m_tcp, nullptr, nullptr);
+            if (c < 0) { if (errno == EINTR) continue; break; }
+            int one = 1;
+            setsockopt(c, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+            setBusyPoll(c, m_busyPoll);
+            std::lock_guard<std::mutex> lk(m_mu);
+            m_conns.push_back(c);
+            m_connThreads.emplace_back([c] {
+                std::vector<char> buf(1 << 20);
+                for (ssize_t r; (r = recv(c, buf.data(), buf.size(), 0)) > 0; )
+                    if (!sendAll(c, buf.data(), size_t(r))) break;
+                close(c);
+            });
+        }
+    }
+    void udpLoop() {
+        std::vector<char> buf(65536);
+        while (!m_stop) {
+            sockaddr_in from{};
+            socklen_t len = sizeof from;
+            ssize_t r = recvfrom(m_udp, buf.data(), buf.size(), 0, reinterpret_cast<sockaddr*>(&from), &len);
+            if (r > 0) sendto(m_udp, buf.data(), size_t(r), 0, reinterpret_cast<sockaddr*>(&from), len);
+        }
+    }
 
-    void setValue(double v, const QString& cap) {
-        m_value = std::clamp(v, 0.0, 1.0);
-        m_captionText = cap;
-        update();
+    int m_tcp = -1, m_udp = -1, m_busyPoll = 0;
+    std::atomic<bool> m_stop{false};
+    std::vector<std::thread> m_threads, m_connThreads;
+    std::vector<int> m_conns;
+    std::mutex m_mu;
+};
+
+// One client connection in a closed loop: send a message, wait for all of
+// it to come back, record the round trip. UDP messages carry a sequence
+// number so late replies to a timed-out request are discarded.
+static void rttClient(bool udp, const sockaddr_in& sa, size_t size, int busyPoll, double seconds, bool live,
+                      const std::string& label, LatencyHistogram& h, uint64_t& lost, bool& failed) {
+    int s = socket(AF_INET, udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+    if (!udp) { int one = 1; setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one); }
+    timeval tv{1, 0};
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof tv);
+    setBusyPoll(s, busyPoll);
+    if (connect(s, reinterpret_cast<const sockaddr*>(&sa), sizeof sa) != 0) { failed = true; close(s); return; }
+    std::vector<char> out(size, 'r'), in(std::max<size_t>(size, 65536));
+    const uint64_t t0 = monoNs(), end = t0 + uint64_t(seconds * 1e9);
+    uint64_t nextLive = t0 + 1000000000ull;
+    for (uint64_t seq = 0, now = t0; now < end && !g_engineStop; ++seq) {
+        if (udp) std::memcpy(out.data(), &seq, sizeof seq);
+        const uint64_t s0 = monoNs();
+        bool ok;
+        if (udp) {
+            ok = send(s, out.data(), size, 0) == ssize_t(size);
+            for (;;) {
+                ssize_t r = recv(s, in.data(), in.size(), 0);
+                if (r < 0) { ok = false; break; }
+                uint64_t got;
+                std::memcpy(&got, in.data(), sizeof got);
+                if (r == ssize_t(size) && got == seq) break;
+            }
+            if (!ok) ++lost;
+        } else {
+            ok = sendAll(s, out.data(), size);
+            for (size_t got = 0; ok && got < size; ) {
+                ssize_t r = recv(s, in.data(), size - got, 0);
+                if (r <= 0) { ok = false; failed = true; }
+                else got += size_t(r);
+            }
+            if (!ok) break;
+        }
+        now = monoNs();
+        if (ok) h.record(now - s0);
+        if (live && now >= nextLive) { emitLatency(label, h); nextLive = now + 1000000000ull; }
     }
+    close(s);
+}
 
-protected:
-    void paintEvent(QPaintEvent*) override {
-        QPainter p(this);
-        p.setRenderHint(QPainter::Antialiasing, true);
+// hst --engine rtt [--role both|client|server] [--proto tcp|udp|both] [--host 127.0.0.1]
+//     [--port 5303] [--sizes 64,1024,16384] [--conns 1] [--busy-poll 0] [--runtime 10]
+// Ping-pong round-trip latency: --conns concurrent connections each keep one
+// message in flight. TCP runs with TCP_NODELAY; --busy-poll sets SO_BUSY_POLL
+// (microseconds) on both ends. Every size and protocol gets a full histogram.
+static int engineRtt(const EngineArgs& a) {
+    const std::string role = a.str("role", "both");
+    const std::string host = a.str("host", "127.0.0.1");
+    const int port = int(a.num("port", 5303));
+    const unsigned conns = unsigned(std::clamp(a.num("conns", 1), 1L, 4096L));
+    const int busyPoll = int(std::clamp(a.num("busy-poll", 0), 0L, 1000000L));
+    const double runtime = std::max(1L, a.num("runtime", 10));
+    const std::string proto = a.str("proto", "both");
+    if (role != "both" && role != "client" && role != "server") { std::printf("error: bad --role\n"); return 2; }
+    std::vector<bool> protos;   // true = udp
+    if (proto == "tcp" || proto == "both") protos.push_back(false);
+    if (proto == "udp" || proto == "both") protos.push_back(true);
+    if (protos.empty()) { std::printf("error: bad --proto\n"); return 2; }
+    std::vector<size_t> sizes;
+    for (std::string rest = a.str("sizes", "64,1024,16384"); !rest.empty(); ) {
+        const size_t comma = rest.find(',');
+        const long v = std::atol(rest.substr(0, comma).c_str());
+        if (v >= 8 && v <= 16 << 20) sizes.push_back(size_t(v));
+        rest = comma == std::string::npos ? "" : rest.substr(comma + 1);
+    }
+    if (sizes.empty()) { std::printf("error: bad --sizes (8 bytes minimum)\n"); return 2; }
 
-        const int pad = 10;
-        const int labelBand = 22;
-        const int arcw = 14;
+    EchoServer server;
+    std::string err;
+    if (role != "client" && !server.start(host, port, conns, busyPoll, err)) {
+        std::printf("error: %s:%d: %s\n", host.c_str(), port, err.c_str());
+        return 1;
+    }
+    if (role == "server") {
+        std::printf("echo server on %s:%d (tcp + udp)%s\n", host.c_str(), port, busyPoll ? "  busy-poll" : "");
+        while (!g_engineStop) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return 0;
+    }
 
-        QRectF arcRect(pad, pad + labelBand,
-                       width() - 2*pad,
-                       std::min(height()*2 - 2*pad, width() - 2*pad));
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(uint16_t(port));
+    if (inet_pton(AF_INET, host.c_str(), &sa.sin_addr) != 1) { std::printf("error: bad --host\n"); return 2; }
 
-        // Label (above arc)
-        p.setPen(m_text);
-        QFont f = font(); f.setBold(true); f.setPointSize(10);
-        p.setFont(f);
-        p.drawText(QRect(0, pad, width(), 16), Qt::AlignHCenter|Qt::AlignVCenter, m_label);
+    std::printf("rtt: %s %s:%d  connections %u  busy-poll %d us  runtime %.0f s per test\n", role.c_str(),
+                host.c_str(), port, conns, busyPoll, runtime);
+    std::printf("%5s %8s %12s %10s %10s %10s %10s %10s %8s\n", "proto", "size", "trans/s", "p50(us)", "p99(us)",
+                "p99.9(us)", "p99.99(us)", "max(us)", "lost");
+    const size_t tests = protos.size() * sizes.size();
+    size_t done = 0;
+    int rc = 0;
+    for (bool udp : protos) {
+        for (size_t size : sizes) {
+            if (g_engineStop) break;
+            if (udp && size > 65507) continue;
+            const std::string label = std::string(udp ? "udp " : "tcp ") + std::to_string(size) + "B";
+            std::vector<std::unique_ptr<LatencyHistogram>> hist(conns);
+            std::vector<uint64_t> lost(conns, 0);
+            std::vector<char> failed(conns, 0);
+            std::vector<std::thread> pool;
+            const uint64_t t0 = monoNs();
+            for (unsigned c = 0; c < conns; ++c) {
+                hist[c] = std::make_unique<LatencyHistogram>();
+                pool.emplace_back([&, c] {
+                    bool f = false;
+                    rttClient(udp, sa, size, busyPoll, runtime, c == 0, label, *hist[c], lost[c], f);
+                    failed[c] = f;
+                });
+            }
+            for (auto& t : pool) t.join();
+            const double secs = (monoNs() - t0) / 1e9;
+            auto merged = std::make_unique<LatencyHistogram>();
+            uint64_t lostTotal = 0;
+            bool anyFailed = false;
+            for (unsigned c = 0; c < conns; ++c) { merged->merge(*hist[c]); lostTotal += lost[c]; anyFailed |= failed[c]; }
+            if (anyFailed) { std::printf("error: %s: connection failed\n", label.c_str()); rc = 1; }
+            const double rate = merged->count() / secs;
+            std::printf("%5s %8zu %12.0f %10.1f %10.1f %10.1f %10.1f %10.1f %8llu\n", udp ? "udp" : "tcp", size, rate,
+                        merged->percentile(50) / 1e3, merged->percentile(99) / 1e3, merged->percentile(99.9) / 1e3,
+                        merged->percentile(99.99) / 1e3, merged->max() / 1e3, (unsigned long long)lostTotal);
+            emitLatency(label, *merged);
+            emitHistogram(label, *merged);
+            emitResult(label, {{"size", double(size)}, {"conns", double(conns)}, {"trans_per_sec", rate},
+                               {"p50_ns", double(merged->percentile(50))}, {"p99_ns", double(merged->percentile(99))},
+                               {"p999_ns", double(merged->percentile(99.9))}, {"p9999_ns", double(merged->percentile(99.99))},
+                               {"max_ns", double(merged->max())}, {"lost", double(lostTotal)}});
+            emitProgress(double(++done) / tests);
+        }
+    }
+    return rc;
+}
 
-        // Track
-        QPen trackPen(m_track, arcw);
-        trackPen.setCapStyle(Qt::RoundCap);
-        p.setPen(trackPen);
-        // use 280 degrees sweep starting at 280
-        p.drawArc(arcRect, 16*280, 16*280);
+// --- Connection establishment rate ---
 
-        // Value arc
-        QPen arcPen(m_arc, arcw);
-        arcPen.setCapStyle(Qt::RoundCap);
-        p.setPen(arcPen);
-        int extent = int(280.0 * m_value);
-        p.drawArc(arcRect, 16*280, 16*extent);
+// hst --engine connrate [--role both|client|server] [--host 127.0.0.1] [--port 5304]
+//     [--acceptors N] [--clients N] [--backlog 1024] [--runtime 10] [--linger0 1]
+//     [--connect-timeout 1000]
+// New TCP connections per second: client threads loop connect -> close while
+// acceptor threads, each with its own SO_REUSEPORT listener, loop accept ->
+// close. Connect latency covers the full handshake; a connect that has not
+// completed within --connect-timeout ms counts as timed out. Clients close with
+// SO_LINGER 0 by default (RST instead of FIN) so TIME_WAIT does not exhaust
+// the ephemeral port range within seconds. Listen-queue and SYN-queue drops
+// are the TcpExt deltas from /proc/net/netstat.
+static int engineConnRate(const EngineArgs& a) {
+    const std::string role = a.str("role", "both");
+    const std::string host = a.str("host", "127.0.0.1");
+    const int port = int(a.num("port", 5304));
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned acceptors = unsigned(std::clamp(a.num("acceptors", long(std::max(1u, hw / 2))), 1L, 256L));
+    const unsigned clients = unsigned(std::clamp(a.num("clients", long(std::max(1u, hw / 2))), 1L, 4096L));
+    const int backlog = int(std::clamp(a.num("backlog", 1024), 1L, 65535L));
+    const double runtime = std::max(1L, a.num("runtime", 10));
+    const bool linger0 = a.flag("linger0", true);
+    const uint64_t connectTimeoutNs = uint64_t(std::clamp(a.num("connect-timeout", 1000), 1L, 600000L)) * 1000000ull;
+    if (role != "both" && role != "client" && role != "server") { std::printf("error: bad --role\n"); return 2; }
 
-        // Center percent
-        QFont fv = font(); fv.setBold(true); fv.setPointSize(12);
-        p.setFont(fv);
-        p.setPen(m_text);
-        QString pct = QString::number(int(std::round(m_value*100))) + "%";
-        QPoint center(width()/2, int(arcRect.top() + arcRect.height()*0.55));
-        p.drawText(QRect(center.x()-60, center.y()-12, 120, 24), Qt::AlignCenter, pct);
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(uint16_t(port));
+    if (inet_pton(AF_INET, host.c_str(), &sa.sin_addr) != 1) { std::printf("error: bad --host\n"); return 2; }
 
-        // Caption
-        p.setFont(font());
-        p.setPen(m_captionColorCoded ? m_arc : m_caption);
-        p.drawText(QRect(0, height()-18, width(), 16), Qt::AlignHCenter|Qt::AlignVCenter, m_captionText);
+    std::atomic<bool> accepting{true};
+    std::atomic<uint64_t> accepted{0}, fdLimited{0};   // accepts failed for want of a descriptor
+    std::vector<int> listeners;
+    std::vector<std::thread> acceptPool;
+    if (role != "client") {
+        for (unsigned i = 0; i < acceptors; ++i) {
+            int l = socket(AF_INET, SOCK_STREAM, 0);
+            int one = 1;
+            setsockopt(l, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+            setsockopt(l, SOL_SOCKET, SO_REUSEPORT, &one, sizeof one);
+            if (bind(l, reinterpret_cast<sockaddr*>(&sa), sizeof sa) != 0 || listen(l, backlog) != 0) {
+                std::printf("error: listen %s:%d: %s\n", host.c_str(), port, std::strerror(errno));
+                close(l);
+                for (int x : listeners) close(x);
+                return 1;
+            }
+            listeners.push_back(l);
+        }
+        for (int l : listeners) {
+            acceptPool.emplace_back([l, &accepting, &accepted, &fdLimited] {
+                while (accepting) {
+                    int c = accept(l, nullptr, nullptr);
+                    if (c >= 0) { close(c); ++accepted; }
+                    else if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                        // Out of descriptors: the connection stays queued; back off instead of spinning
+                        ++fdLimited;
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    else if (errno != EINTR && errno != ECONNABORTED) break;
+                }
+            });
+        }
     }
+    auto stopAcceptors = [&] {
+        accepting = false;
+        for (int l : listeners) shutdown(l, SHUT_RDWR);
+        for (auto& t : acceptPool) t.join();
+        for (int l : listeners) close(l);
+    };
+    const auto net0 = readNetStats("/proc/net/netstat", "TcpExt");
+    auto drops = [&](const char* k) {
+        auto now = readNetStats("/proc/net/netstat", "TcpExt");
+        auto before = net0.find(k);
+        return double(now[k] - (before == net0.end() ? 0 : before->second));
+    };
 
-private:
-    QString m_label, m_captionText;
-    QColor  m_arc  = QColor("#84cc16");
-    QColor  m_track= QColor("#c7ced6");
-    QColor  m_text = Qt::black;
-    QColor  m_caption = Qt::black;
-    bool    m_captionColorCoded = false;
-    double  m_value = 0.0;
-};
+    if (role == "server") {
+        std::printf("connection server on %s:%d  %u SO_REUSEPORT acceptor(s)  backlog %d\n", host.c_str(), port,
+                    acceptors, backlog);
+        uint64_t last = 0;
+        while (!g_engineStop) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            const uint64_t now = accepted;
+            std::printf("  %10.0f accepts/s  ListenOverflows %.0f  ListenDrops %.0f  out of fds %llu\n",
+                        double(now - last), drops("ListenOverflows"), drops("ListenDrops"),
+                        (unsigned long long)fdLimited.load());
+            last = now;
+        }
+        stopAcceptors();
+        return 0;
+    }
 
-// -----------------------------
-// Lightweight system monitor (Linux)
-// -----------------------------
+    std::printf("connrate: %s %s:%d  clients %u  acceptors %u  backlog %d  close: %s\n", role.c_str(), host.c_str(),
+                port, clients, role == "both" ? acceptors : 0, backlog, linger0 ? "RST (linger 0)" : "FIN");
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> connected{0};
+    std::vector<std::unique_ptr<LatencyHistogram>> hist(clients);
+    std::vector<std::array<uint64_t, 3>> errs(clients);   // refused, timed out, other
+    std::vector<std::thread> pool;
+    const uint64_t t0 = monoNs();
+    for (unsigned c = 0; c < clients; ++c) {
+        hist[c] = std::make_unique<LatencyHistogram>();
+        pool.emplace_back([&, c] {
+            const linger lg{1, 0};
+            while (running) {
+                int s = socket(AF_INET, SOCK_STREAM|SOCK_NONBLOCK, 0);
+                if (s < 0) { ++errs[c][2]; continue; }
+                // Non-blocking, so a lost SYN cannot hold the thread past the run or the timeout
+                const uint64_t s0 = monoNs();
+                int err = connect(s, reinterpret_cast<const sockaddr*>(&sa), sizeof sa) == 0 ? 0 : errno;
+                if (err == EINPROGRESS) {
+                    pollfd pfd{s, POLLOUT, 0};
+                    err = ETIMEDOUT;
+                    for (uint64_t now = s0; running && now - s0 < connectTimeoutNs; now = monoNs()) {
+                        const int wait = int(std::min<uint64_t>(100, (connectTimeoutNs - (now - s0)) / 1000000 + 1));
+                        if (poll(&pfd, 1, wait) > 0) {
+                            socklen_t len = sizeof err;
+                            getsockopt(s, SOL_SOCKET, SO_ERROR, &err, &len);
+                            break;
+                        }
+                    }
+                    if (err == ETIMEDOUT && !running) { close(s); break; }   // cut short by the end of the run
+                }
+                if (err == 0) {
+                    hist[c]->record(monoNs() - s0);
+                    ++connected;
+                    if (linger0) setsockopt(s, SOL_SOCKET, SO_LINGER, &lg, sizeof lg);
+                } else {
+                    ++errs[c][err == ECONNREFUSED ? 0 : err == ETIMEDOUT ? 1 : 2];
+                }
+                close(s);
+            }
+        });
+    }
+    uint64_t last = 0, lastT = t0;
+    while (!g_engineStop && monoNs() - t0 < uint64_t(runtime * 1e9)) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        const uint64_t now = monoNs(), n = connected;
+        std::printf("  %5.1fs %10.0f conn/s\n", (now - t0) / 1e9, (n - last) / ((now - lastT) / 1e9));
+        emitProgress(std::min(1.0, (now - t0) / (runtime * 1e9)));
+        last = n; lastT = now;
+    }
+    running = false;
+    for (auto& t : pool) t.join();
+    const double secs = (monoNs() - t0) / 1e9;
+    if (role == "both") stopAcceptors();
 
-struct CpuSnapshot {
-    quint64 user=0,nice=0,sys=0,idle=0,iowait=0,irq=0,softirq=0,steal=0,guest=0,guest_nice=0;
-};
-static std::optional<CpuSnapshot> readCpu() {
-    QFile f("/proc/stat");
-    if (!f.open(QIODevice::ReadOnly|QIODevice::Text)) return std::nullopt;
-    auto line = f.readLine();
-    QTextStream ts(line);
-    QString cpu; ts >> cpu; if (cpu != "cpu") return std::nullopt;
-    CpuSnapshot s;
-    ts >> s.user >> s.nice >> s.sys >> s.idle >> s.iowait >> s.irq >> s.softirq >> s.steal >> s.guest >> s.guest_nice;
-    return s;
+    auto merged = std::make_unique<LatencyHistogram>();
+    uint64_t refused = 0, timedOut = 0, other = 0;
+    for (unsigned c = 0; c < clients; ++c) {
+        merged->merge(*hist[c]);
+        refused += errs[c][0]; timedOut += errs[c][1]; other += errs[c][2];
+    }
+    const double rate = merged->count() / secs;
+    std::printf("%12s %10s %10s %10s %10s %10s %10s %10s\n", "conn/s", "p50(us)", "p99(us)", "p99.9(us)", "max(us)",
+                "refused", "timeout", "other");
+    std::printf("%12.0f %10.1f %10.1f %10.1f %10.1f %10llu %10llu %10llu\n", rate, merged->percentile(50) / 1e3,
+                merged->percentile(99) / 1e3, merged->percentile(99.9) / 1e3, merged->max() / 1e3,
+                (unsigned long long)refused, (unsigned long long)timedOut, (unsigned long long)other);
+    const double overflows = drops("ListenOverflows"), listenDrops = drops("ListenDrops");
+    const double synDrops = drops("TCPReqQFullDrop"), cookies = drops("TCPReqQFullDoCookies");
+    std::printf("ListenOverflows %.0f  ListenDrops %.0f  SYN queue full drops %.0f  syncookies sent %.0f\n",
+                overflows, listenDrops, synDrops, cookies);
+    if (fdLimited) std::printf("warning: accept ran out of file descriptors %llu times (raise ulimit -n)\n",
+                               (unsigned long long)fdLimited.load());
+    emitLatency("connect", *merged);
+    emitHistogram("connect", *merged);
+    emitResult("connrate", {{"conn_per_sec", rate}, {"clients", double(clients)}, {"acceptors", double(acceptors)},
+                            {"p50_ns", double(merged->percentile(50))}, {"p99_ns", double(merged->percentile(99))},
+                            {"p999_ns", double(merged->percentile(99.9))}, {"refused", double(refused)},
+                            {"timed_out", double(timedOut)}, {"other_errors", double(other)},
+                            {"listen_overflows", overflows}, {"listen_drops", listenDrops},
+                            {"syn_queue_drops", synDrops}, {"syncookies", cookies},
+                            {"accept_fd_exhausted", double(fdLimited.load())}});
+    return 0;
 }
-static double cpuPercent() {
-    static auto prev = readCpu();
-    auto now = readCpu();
-    if (!prev || !now) return 0.0;
-    auto deltaIdle = (now->idle + now->iowait) - (prev->idle + prev->iowait);
-    auto prevNon = (prev->user+prev->nice+prev->sys+prev->irq+prev->softirq+prev->steal);
-    auto nowNon  = (now->user +now->nice +now->sys +now->irq +now->softirq +now->steal);
-    auto deltaNon = nowNon - prevNon;
-    auto total = deltaIdle + deltaNon;
-    prev = now;
-    if (total <= 0) return 0.0;
-    return (double(deltaNon) / double(total)) * 100.0;
-}
-
-static double memPercent(double* usedGiB=nullptr, double* totalGiB=nullptr) {
-    QFile f("/proc/meminfo");
-    if (!f.open(QIODevice::ReadOnly|QIODevice::Text)) return 0.0;
-    QHash<QString,qulonglong> map;
-    while (!f.atEnd()) {
-        auto line = f.readLine();
-        auto parts = QString(line).split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-        if (parts.size() >= 2) {
-            bool ok=false;
-            qulonglong kB = parts[1].toULongLong(&ok);
-            if (ok) map[parts[0].remove(':')] = kB; // store in kB
-        }
-    }
-    qulonglong MemTotal = map.value("MemTotal",0);
-    qulonglong MemFree  = map.value("MemFree",0);
-    qulonglong Buffers  = map.value("Buffers",0);
-    qulonglong Cached   = map.value("Cached",0);
-    qulonglong SReclaim = map.value("SReclaimable",0);
-    qulonglong Shmem    = map.value("Shmem",0);
-
-    qulonglong avail_kB = map.value("MemAvailable",0);
-    double used_kB = (MemTotal - avail_kB);
-    double pct = (MemTotal == 0) ? 0.0 : (used_kB / double(MemTotal)) * 100.0;
 
-    if (usedGiB)  *usedGiB = used_kB/1024.0/1024.0;
-    if (totalGiB) *totalGiB = MemTotal/1024.0/1024.0;
-    return pct;
+// hst --engine prep --file F --size S [--reuse 1] [-- command ...]
+// Prepares (or reuses) the test file, then execs the command, e.g. fio.
+static int enginePrep(const EngineArgs& a) {
+    const std::string path = a.str("file");
+    if (path.empty()) { std::printf("error: --file is required\n"); return 2; }
+    struct stat st{};
+    if (!(stat(path.c_str(), &st) == 0 && S_ISBLK(st.st_mode))) {
+        std::string err;
+        if (!prepareTestFile(path, a.bytes("size", 1ull << 30), a.flag("reuse", true), err)) {
+            std::printf("error: %s\n", err.empty() ? "interrupted" : err.c_str());
+            return 1;
+        }
+    }
+    if (a.rest.empty()) return 0;
+    std::vector<char*> argv(a.rest);
+    argv.push_back(nullptr);
+    std::fflush(stdout);
+    execvp(argv[0], argv.data());
+    std::printf("error: %s: %s\n", argv[0], std::strerror(errno));
+    return 127;
 }
 
-static double rootDiskPercent(double* usedGiB=nullptr, double* totalGiB=nullptr) {
-    struct statvfs s{};
-    if (statvfs("/", &s) != 0) return 0.0;
-    unsigned long long total = s.f_blocks * (unsigned long long)s.f_frsize;
-    unsigned long long avail = s.f_bavail * (unsigned long long)s.f_frsize;
-    unsigned long long used  = total - avail;
-    if (total == 0) return 0.0;
-    if (usedGiB)  *usedGiB  = used / (1024.0*1024.0*1024.0);
-    if (totalGiB) *totalGiB = total / (1024.0*1024.0*1024.0);
-    return (double)used / (double)total * 100.0;
+static void engineSignal(int) { g_engineStop = true; }
+
+static int runEngine(int argc, char** argv) {
+    std::setvbuf(stdout, nullptr, _IOLBF, 0);
+    struct sigaction sa{};
+    sa.sa_handler = engineSignal;   // no SA_RESTART: blocking waits return EINTR
+    sigaction(SIGTERM, &sa, nullptr);
+    sigaction(SIGINT, &sa, nullptr);
+
+    if (argc < 1) { std::printf("usage: hst --engine disk|wal|meta|verify|cache|mmap|tcp|udp|rtt|connrate|iperf-local|prep|devices [options]\n"); return 2; }
+    const std::string name = argv[0];
+    EngineArgs a(argc - 1, argv + 1);
+    if (name == "disk") return engineDisk(a);
+    if (name == "wal")  return engineWal(a);
+    if (name == "meta") return engineMeta(a);
+    if (name == "verify") return engineVerify(a);
+    if (name == "prep") return enginePrep(a);
+    if (name == "devices") return engineDevices(a);
+    if (name == "cache") return engineCache(a);
+    if (name == "mmap") return engineMmap(a);
+    if (name == "iperf-local") return engineIperfLocal(a);
+    if (name == "tcp") return engineTcp(a);
+    if (name == "udp") return engineUdp(a);
+    if (name == "rtt") return engineRtt(a);
+    if (name == "connrate") return engineConnRate(a);
+    std::printf("error: unknown engine '%s'\n", name.c_str());
+    return 2;
 }
 
 // -----------------------------
@@ -218,7 +3960,8 @@ public:
         buildUi();
         connectSignals();
         applyLightTheme();
-        monitorTimer.start(1000);
+        sampler.start();
+        monitorTimer.start(500);
     }
 
 private:
@@ -230,24 +3973,78 @@ private:
     // Options panes
     QWidget *cpuOpts=nullptr,*ramOpts=nullptr,*gpuOpts=nullptr,*diskOpts=nullptr,*netOpts=nullptr;
     QSpinBox *cpuWorkers=nullptr, *cpuDuration=nullptr;
+    QComboBox* cpuClass=nullptr; QListWidget* cpuStressors=nullptr; QLineEdit* cpuStressOpts=nullptr; QLabel* cpuOptHelp=nullptr;
+    int stressScanGen = 0;   // a newer Rescan supersedes answers still in flight
     QSpinBox *ramWorkers=nullptr, *ramDuration=nullptr; QLineEdit* ramBytes=nullptr;
     QLineEdit *diskSize=nullptr, *diskFilename=nullptr; QSpinBox *diskRuntime=nullptr;
+    QComboBox *diskEngine=nullptr, *diskPattern=nullptr; QLineEdit *diskBs=nullptr;
+    QSpinBox *diskDepth=nullptr; QCheckBox *diskSweep=nullptr, *diskSqpoll=nullptr, *diskMatrix=nullptr;
+    QListWidget *diskDevices=nullptr; QCheckBox *diskRawWrite=nullptr;
+    enum DiskWorkload { DiskThroughput, DiskWal, DiskMeta, DiskVerify, DiskCache, DiskMmap };
+    QComboBox *diskWorkload=nullptr; QCheckBox *diskReuse=nullptr;
+    QSpinBox *metaFiles=nullptr, *metaFanout=nullptr, *metaThreads=nullptr; QLineEdit *metaSize=nullptr;
+    QLineEdit *verifyBs=nullptr; QSpinBox *verifyPasses=nullptr; QCheckBox *verifyDirect=nullptr, *verifyDrop=nullptr;
+    QLineEdit *cacheBs=nullptr, *cacheReadahead=nullptr;
+    QComboBox *mmapPattern=nullptr, *mmapAdvise=nullptr; QLineEdit *mmapBs=nullptr;
+    QCheckBox *mmapPopulate=nullptr, *mmapCompare=nullptr;
+    QComboBox *walSync=nullptr; QLineEdit *walRecord=nullptr; QSpinBox *walBatch=nullptr; QCheckBox *walPrealloc=nullptr;
     QLineEdit *netServer=nullptr, *netExtra=nullptr;
+    QCheckBox *netLocal=nullptr; QComboBox *netIface=nullptr; QLineEdit *netNs=nullptr;
+    enum NetEngine { NetIperf, NetTcp, NetUdp, NetRtt, NetConnRate };
+    QComboBox *netEngine=nullptr; QSpinBox *netDuration=nullptr;
+    QSpinBox *tcpStreams=nullptr, *tcpThreads=nullptr; QComboBox *tcpPath=nullptr; QLineEdit *tcpMsg=nullptr;
+    QLineEdit *udpSizes=nullptr; QSpinBox *udpThreads=nullptr, *udpBatch=nullptr;
+    QComboBox *rttProto=nullptr; QLineEdit *rttSizes=nullptr; QSpinBox *rttConns=nullptr, *rttBusyPoll=nullptr;
+    QSpinBox *crClients=nullptr, *crAcceptors=nullptr, *crBacklog=nullptr; QCheckBox *crLinger=nullptr;
 
     // Controls
     QPushButton *btnStart=nullptr,*btnStop=nullptr,*btnClear=nullptr;
-    QProgressBar* progress=nullptr; QLabel* eta=nullptr;
+    QProgressBar* progress=nullptr; QLabel* eta=nullptr; QLabel* latency=nullptr;
     QTextEdit *output=nullptr;
+    QTabWidget *tabs=nullptr;
+    QWidget *matrixTab=nullptr;
+    HeatmapWidget *heatBw=nullptr, *heatP99=nullptr;
+    QWidget *netTab=nullptr;
+    TimeSeriesWidget *chartBps=nullptr, *chartRetr=nullptr, *chartCwnd=nullptr, *chartRtt=nullptr;
+    QWidget *gpuTab=nullptr; QTableWidget* gpuTable=nullptr;
+    TimeSeriesWidget *chartFps=nullptr, *chartFrame=nullptr;
+    QCheckBox *gpuOffscreen=nullptr, *gpuSoftware=nullptr;
+    QWidget *sysTab=nullptr; QComboBox* sysWindow=nullptr;
+    TimeSeriesWidget *chartSysUtil=nullptr, *chartSysStall=nullptr;
+    QWidget *fioTab=nullptr;
+    TimeSeriesWidget *chartIops=nullptr, *chartFioBw=nullptr, *chartClat=nullptr, *chartUtil=nullptr;
 
     // Dashboard
     DonutGauge *gCpu=nullptr,*gMem=nullptr,*gDsk=nullptr;
+    CoreStripWidget* gCores=nullptr;
 
     // Process + timers + logging
     QProcess proc;
-    QTimer monitorTimer;
+    QTimer monitorTimer;          // UI refresh; the samples come from the sampler thread
+    SamplerThread sampler{1};
+    uint64_t runStartNs = 0;
+    int dashTicks = 0;
     QElapsedTimer runTimer;
     std::optional<int> expectedSeconds;
     QFile logFile;
+    QByteArray stdoutBuf;        // partial "@hst" record line awaiting its newline
+    QJsonObject runRecord;       // structured results, saved as <log>.json
+    QString runRecordPath;
+    // Tool JSON on stdout: iperf3 --json-stream is one event object per line;
+    // iperf3 -J (one document at exit) and fio --status-interval (one document per
+    // interval) are pretty-printed objects from a "{" line to a "}" line.
+    enum class JsonOut { Off, IperfStream, IperfDoc, FioDoc } jsonOut = JsonOut::Off;
+    QByteArray jsonDoc;
+    bool jsonDocOpen = false;
+    // fio reports cumulative totals; the previous status turns them into per-interval rates
+    struct FioTotals { double t=0, readBytes=0, writeBytes=0, readIos=0, writeIos=0; } fioPrev;
+    QJsonObject fioLast;
+    QString stressYamlPath;      // stress-ng --yaml report, next to the log
+    // glmark2: scene lines are parsed as they arrive; the default suite has ~33 scenes
+    static constexpr int kGlmarkScenes = 33;
+    bool glmarkRun = false;
+    int glmarkDone = 0;
+    QString glRenderer;
 
     // Theme state
     bool captionColorCoded=false;
@@ -264,6 +4061,7 @@ private:
         QMenu *mFile = menuBar()->addMenu("&File");
         QAction *actSave = mFile->addAction("Save Output As…");
         QAction *actLog  = mFile->addAction("Open Log Folder");
+        QAction *actHist = mFile->addAction("Export Metrics History…");
         mFile->addSeparator();
         QAction *actExit = mFile->addAction("Exit");
 
@@ -275,6 +4073,22 @@ private:
         QActionGroup *themeGroup = new QActionGroup(this);
         themeGroup->addAction(actLight); themeGroup->addAction(actDark);
         QAction *actColorCaption = mTheme->addAction("Color-code gauge captions"); actColorCaption->setCheckable(true);
+        // Dashboard sampling rate, independent of the twice-a-second UI refresh
+        QMenu *mRate = mTools->addMenu("Sample Rate");
+        QActionGroup *rateGroup = new QActionGroup(this);
+        for (int hz : {1, 10, 100, 1000}) {
+            QAction* a = mRate->addAction(QString("%1 Hz").arg(hz)); a->setCheckable(true); a->setChecked(hz == 1);
+            rateGroup->addAction(a);
+            connect(a,&QAction::triggered,this,[this,hz]{ sampler.setRateHz(hz); });
+        }
+        QAction *actRateCustom = mRate->addAction("Custom…"); actRateCustom->setCheckable(true);
+        rateGroup->addAction(actRateCustom);
+        connect(actRateCustom,&QAction::triggered,this,[this]{
+            bool ok = false;
+            int hz = QInputDialog::getInt(this, "Sample Rate", "Samples per second:", sampler.rateHz(),
+                                          1, SamplerThread::kMaxHz, 1, &ok);
+            if (ok) sampler.setRateHz(hz);
+        });
 
         QMenu *mHelp = menuBar()->addMenu("&Help");
         QAction *actAbout = mHelp->addAction("About");
@@ -282,6 +4096,7 @@ private:
         // store for signals
         connect(actSave,&QAction::triggered,this,&MainWindow::saveOutputAs);
         connect(actLog,&QAction::triggered,this,&MainWindow::openLogFolder);
+        connect(actHist,&QAction::triggered,this,&MainWindow::exportHistory);
         connect(actExit,&QAction::triggered,this,&MainWindow::close);
         connect(actDeps,&QAction::triggered,this,&MainWindow::checkDependenciesDialog);
         connect(actLight,&QAction::triggered,this,&MainWindow::applyLightTheme);
@@ -318,6 +4133,32 @@ private:
             cpuDuration= new QSpinBox; cpuDuration->setRange(5, 86400); cpuDuration->setValue(300);
             gl->addWidget(new QLabel("Workers:"),0,0); gl->addWidget(cpuWorkers,0,1);
             gl->addWidget(new QLabel("Duration (s):"),0,2); gl->addWidget(cpuDuration,0,3);
+            // Stressor catalogue of the installed stress-ng; ticked ones run together
+            cpuClass = new QComboBox;
+            cpuStressors = new QListWidget; cpuStressors->setMaximumHeight(110);
+            cpuStressors->setToolTip("Ticked stressors run together, each with Workers instances;\n"
+                                     "with none ticked the plain CPU stressor is used");
+            cpuStressOpts = new QLineEdit;
+            cpuStressOpts->setPlaceholderText("per-stressor options, e.g. --matrix-size 256 --cache-level 2");
+            cpuOptHelp = new QLabel; cpuOptHelp->setWordWrap(true);
+            QPushButton* rescan = new QPushButton("Rescan");
+            gl->addWidget(new QLabel("Class:"),1,0); gl->addWidget(cpuClass,1,1); gl->addWidget(rescan,1,3);
+            gl->addWidget(new QLabel("Stressors:"),2,0); gl->addWidget(cpuStressors,2,1,1,3);
+            gl->addWidget(new QLabel("Options:"),3,0); gl->addWidget(cpuStressOpts,3,1,1,3);
+            gl->addWidget(cpuOptHelp,4,1,1,3);
+            connect(rescan,&QPushButton::clicked,this,&MainWindow::scanStressors);
+            connect(cpuClass,&QComboBox::currentIndexChanged,this,[this](int){
+                const QString cls = cpuClass->currentData().toString();
+                for (int i = 0; i < cpuStressors->count(); ++i) {
+                    auto* it = cpuStressors->item(i);
+                    it->setHidden(!cls.isEmpty() && !it->data(Qt::UserRole+1).toStringList().contains(cls)
+                                  && it->checkState() != Qt::Checked);
+                }
+            });
+            connect(cpuStressors,&QListWidget::currentItemChanged,this,[this](QListWidgetItem* it, QListWidgetItem*){
+                cpuOptHelp->setText(it ? it->toolTip() : QString());
+            });
+            scanStressors();
             cpuOpts=f;
         }
         // RAM
@@ -334,7 +4175,13 @@ private:
         // GPU
         {
             QWidget* f = new QWidget; QHBoxLayout* hl = new QHBoxLayout(f);
-            hl->addWidget(new QLabel("glmark2 runs a fixed suite and exits (no duration setting)."));
+            gpuOffscreen = new QCheckBox("Off-screen"); gpuOffscreen->setChecked(true);
+            gpuOffscreen->setToolTip("Render to an off-screen surface: no window, not capped by the display refresh");
+            gpuSoftware = new QCheckBox("Software rendering (llvmpipe)");
+            gpuSoftware->setToolTip("LIBGL_ALWAYS_SOFTWARE=1 GALLIUM_DRIVER=llvmpipe: Mesa rasterizes on the CPU,\n"
+                                    "which also makes this a CPU rendering benchmark on hosts without a GPU");
+            hl->addWidget(new QLabel("glmark2 runs its fixed scene suite (about 33 scenes)."));
+            hl->addWidget(gpuOffscreen); hl->addWidget(gpuSoftware); hl->addStretch(1);
             gpuOpts=f;
         }
         // Disk
@@ -346,14 +4193,218 @@ private:
             gl->addWidget(new QLabel("Size:"),0,0); gl->addWidget(diskSize,0,1);
             gl->addWidget(new QLabel("Runtime (s):"),0,2); gl->addWidget(diskRuntime,0,3);
             gl->addWidget(new QLabel("Filename:"),0,4); gl->addWidget(diskFilename,0,5);
+            diskWorkload = new QComboBox;
+            diskWorkload->addItems({"Throughput","WAL commit (fsync)","Metadata (create/stat/rename/unlink)",
+                                    "Data verification","Buffered I/O (page cache)","Memory-mapped I/O"});
+            QStackedWidget* diskStack = new QStackedWidget;
+            diskReuse = new QCheckBox("Reuse prepared test file"); diskReuse->setChecked(true);
+            diskReuse->setToolTip("Skip laying out the file again when a previous run already prepared it\n"
+                                  "(tracked in ~/HardwareStressTest/testfile-manifest.tsv)");
+            gl->addWidget(new QLabel("Workload:"),1,0); gl->addWidget(diskWorkload,1,1);
+            gl->addWidget(diskReuse,1,2,1,2);
+            gl->addWidget(diskStack,2,0,1,6);
+            connect(diskWorkload,&QComboBox::currentIndexChanged,diskStack,&QStackedWidget::setCurrentIndex);
+
+            // Throughput (fio or native engine)
+            QWidget* tp = new QWidget; gl = new QGridLayout(tp); gl->setContentsMargins(0,0,0,0);
+            diskEngine  = new QComboBox;
+            diskEngine->addItems({"fio","native (io_uring)","native (libaio)","native (psync)"});
+            diskPattern = new QComboBox;
+            diskPattern->addItems({"randread","randwrite","randrw","read","write"});
+            diskBs      = new QLineEdit("4k");
+            diskDepth   = new QSpinBox; diskDepth->setRange(1,256); diskDepth->setValue(32);
+            diskSweep   = new QCheckBox("QD sweep 1..256");
+            diskSqpoll  = new QCheckBox("SQPOLL");
+            diskMatrix  = new QCheckBox("BS × mix matrix");
+            diskMatrix->setToolTip("Block sizes 4k..4m × sequential/random × read 0/30/50/70/100%");
+            gl->addWidget(new QLabel("Engine:"),0,0); gl->addWidget(diskEngine,0,1);
+            gl->addWidget(new QLabel("Pattern:"),0,2); gl->addWidget(diskPattern,0,3);
+            gl->addWidget(new QLabel("Block size:"),0,4); gl->addWidget(diskBs,0,5);
+            gl->addWidget(new QLabel("Queue depth:"),1,0); gl->addWidget(diskDepth,1,1);
+            gl->addWidget(diskSweep,1,2,1,2); gl->addWidget(diskSqpoll,1,4); gl->addWidget(diskMatrix,1,5);
+            // Block devices: when any are ticked they replace Filename and run concurrently
+            diskDevices = new QListWidget; diskDevices->setMaximumHeight(96);
+            diskDevices->setToolTip("Ticked devices are tested at the same time instead of Filename;\n"
+                                    "results are reported per device and in aggregate");
+            diskRawWrite = new QCheckBox("Allow raw writes");
+            diskRawWrite->setToolTip("Write patterns destroy data on raw devices; without this only reads are issued.\n"
+                                     "Loop devices are always writable. Mounted devices are never written.");
+            QPushButton* rescan = new QPushButton("Rescan");
+            QVBoxLayout* dv = new QVBoxLayout; dv->addWidget(rescan); dv->addWidget(diskRawWrite); dv->addStretch(1);
+            gl->addWidget(new QLabel("Devices:"),2,0); gl->addWidget(diskDevices,2,1,1,4); gl->addLayout(dv,2,5);
+            connect(rescan,&QPushButton::clicked,this,&MainWindow::scanBlockDevices);
+            scanBlockDevices();
+            auto syncNative = [this](){
+                bool native = diskEngine->currentIndex() > 0;
+                bool matrix = native && diskMatrix->isChecked();
+                bool multi = selectedDevices().size() > 1;
+                diskMatrix->setEnabled(native && !multi);
+                diskSweep->setEnabled(native && !matrix && !multi);
+                diskPattern->setEnabled(native && !matrix);
+                diskBs->setEnabled(native && !matrix);
+                diskSqpoll->setEnabled(diskEngine->currentIndex() == 1);
+                diskDepth->setEnabled(native && (matrix || !diskSweep->isChecked()));
+            };
+            connect(diskEngine,&QComboBox::currentIndexChanged,this,syncNative);
+            connect(diskSweep,&QCheckBox::toggled,this,syncNative);
+            connect(diskMatrix,&QCheckBox::toggled,this,syncNative);
+            connect(diskDevices,&QListWidget::itemChanged,this,syncNative);
+            syncNative();
+            diskStack->addWidget(tp);
+
+            // WAL commit latency (native)
+            QWidget* wp = new QWidget; gl = new QGridLayout(wp); gl->setContentsMargins(0,0,0,0);
+            walSync    = new QComboBox; walSync->addItems({"fdatasync","fsync","O_DSYNC"});
+            walRecord  = new QLineEdit("4k");
+            walBatch   = new QSpinBox; walBatch->setRange(1,1024); walBatch->setValue(1);
+            walPrealloc= new QCheckBox("Preallocated segment (Size)"); walPrealloc->setChecked(true);
+            gl->addWidget(new QLabel("Sync:"),0,0); gl->addWidget(walSync,0,1);
+            gl->addWidget(new QLabel("Record size:"),0,2); gl->addWidget(walRecord,0,3);
+            gl->addWidget(new QLabel("Group commit:"),0,4); gl->addWidget(walBatch,0,5);
+            gl->addWidget(walPrealloc,1,0,1,3);
+            diskStack->addWidget(wp);
+
+            // Filesystem metadata (native), in the Filename's directory
+            QWidget* mp = new QWidget; gl = new QGridLayout(mp); gl->setContentsMargins(0,0,0,0);
+            metaFiles   = new QSpinBox; metaFiles->setRange(1000,50000000); metaFiles->setSingleStep(100000); metaFiles->setValue(1000000);
+            metaFanout  = new QSpinBox; metaFanout->setRange(1,100000); metaFanout->setValue(1000);
+            metaThreads = new QSpinBox; metaThreads->setRange(1,512); metaThreads->setValue(std::max(1, QThread::idealThreadCount()));
+            metaSize    = new QLineEdit("0");
+            gl->addWidget(new QLabel("Files:"),0,0); gl->addWidget(metaFiles,0,1);
+            gl->addWidget(new QLabel("Directories:"),0,2); gl->addWidget(metaFanout,0,3);
+            gl->addWidget(new QLabel("Threads:"),0,4); gl->addWidget(metaThreads,0,5);
+            gl->addWidget(new QLabel("File size:"),1,0); gl->addWidget(metaSize,1,1);
+            gl->addWidget(new QLabel("Runs in the Filename's directory; Runtime is not used."),1,2,1,4);
+            diskStack->addWidget(mp);
+
+            // End-to-end data verification (native)
+            QWidget* vp = new QWidget; gl = new QGridLayout(vp); gl->setContentsMargins(0,0,0,0);
+            verifyBs     = new QLineEdit("4k");
+            verifyPasses = new QSpinBox; verifyPasses->setRange(1,100); verifyPasses->setValue(2);
+            verifyDirect = new QCheckBox("O_DIRECT read-back"); verifyDirect->setChecked(true);
+            verifyDrop   = new QCheckBox("Drop caches before read-back");
+            verifyDrop->setToolTip("posix_fadvise(DONTNEED); also /proc/sys/vm/drop_caches when run as root");
+            gl->addWidget(new QLabel("Block size:"),0,0); gl->addWidget(verifyBs,0,1);
+            gl->addWidget(new QLabel("Passes:"),0,2); gl->addWidget(verifyPasses,0,3);
+            gl->addWidget(verifyDirect,0,4); gl->addWidget(verifyDrop,0,5);
+            diskStack->addWidget(vp);
+
+            // Buffered I/O: cold vs warm page cache, per read_ahead_kb (native)
+            QWidget* cp = new QWidget; gl = new QGridLayout(cp); gl->setContentsMargins(0,0,0,0);
+            cacheBs        = new QLineEdit("128k");
+            cacheReadahead = new QLineEdit("128,512,2048");
+            cacheReadahead->setToolTip("read_ahead_kb values to compare (needs root; the original value is restored)");
+            gl->addWidget(new QLabel("Sequential block size:"),0,0); gl->addWidget(cacheBs,0,1);
+            gl->addWidget(new QLabel("read_ahead_kb:"),0,2); gl->addWidget(cacheReadahead,0,3);
+            diskStack->addWidget(cp);
+
+            // Memory-mapped I/O (native), optionally against pread/pwrite and io_uring
+            QWidget* mm = new QWidget; gl = new QGridLayout(mm); gl->setContentsMargins(0,0,0,0);
+            mmapPattern  = new QComboBox; mmapPattern->addItems({"randread","randwrite","randrw","read","write"});
+            mmapBs       = new QLineEdit("4k");
+            mmapAdvise   = new QComboBox; mmapAdvise->addItems({"normal","random","sequential","willneed","hugepage"});
+            mmapPopulate = new QCheckBox("MAP_POPULATE");
+            mmapCompare  = new QCheckBox("Compare with pread/pwrite and io_uring"); mmapCompare->setChecked(true);
+            gl->addWidget(new QLabel("Pattern:"),0,0); gl->addWidget(mmapPattern,0,1);
+            gl->addWidget(new QLabel("Block size:"),0,2); gl->addWidget(mmapBs,0,3);
+            gl->addWidget(new QLabel("madvise:"),0,4); gl->addWidget(mmapAdvise,0,5);
+            gl->addWidget(mmapPopulate,1,0,1,2); gl->addWidget(mmapCompare,1,2,1,4);
+            diskStack->addWidget(mm);
             diskOpts=f;
         }
         // Net
         {
             QWidget* f = new QWidget; QGridLayout* gl = new QGridLayout(f);
             netServer = new QLineEdit; netExtra = new QLineEdit;
-            gl->addWidget(new QLabel("iperf3 Server IP:"),0,0); gl->addWidget(netServer,0,1);
+            gl->addWidget(new QLabel("Server IP:"),0,0); gl->addWidget(netServer,0,1);
             gl->addWidget(new QLabel("Extra args (optional):"),0,2); gl->addWidget(netExtra,0,3);
+            // Managed iperf3 server on this host: no remote peer needed
+            netLocal = new QCheckBox("Local server");
+            netIface = new QComboBox;
+            for (const auto& [name, addr] : listInterfaceAddrs())
+                netIface->addItem(QString("%1 (%2)").arg(QString::fromStdString(name), QString::fromStdString(addr)),
+                                  QString::fromStdString(addr));
+            netIface->setToolTip("Address both ends bind to. Traffic to a local address stays in the host stack.");
+            netLocal->setToolTip("iperf3: start iperf3 -s on an ephemeral port, run the client against it, stop it afterwards.\n"
+                                 "Native engines: run both ends in this process.");
+            netNs = new QLineEdit; netNs->setPlaceholderText("network namespace (optional)");
+            netNs->setToolTip("Run server and client inside this namespace over its loopback (ip netns exec; needs root)");
+            gl->addWidget(netLocal,1,0); gl->addWidget(netIface,1,1); gl->addWidget(netNs,1,2,1,2);
+            auto syncLocal = [this](){
+                bool local = netLocal->isChecked();
+                netServer->setEnabled(!local); netNs->setEnabled(local);
+                netIface->setEnabled(local && netNs->text().trimmed().isEmpty());
+            };
+            connect(netLocal,&QCheckBox::toggled,this,syncLocal);
+            connect(netNs,&QLineEdit::textChanged,this,syncLocal);
+            syncLocal();
+
+            // Engine: iperf3, or a native engine (the remote end runs "hst --engine <name> --role server")
+            netEngine = new QComboBox;
+            netEngine->addItems({"iperf3","native TCP (multi-stream)","native UDP (packets/s)",
+                                 "native request/response latency","native connection rate"});
+            netDuration = new QSpinBox; netDuration->setRange(2,3600); netDuration->setValue(30);
+            QStackedWidget* netStack = new QStackedWidget;
+            gl->addWidget(new QLabel("Engine:"),2,0); gl->addWidget(netEngine,2,1);
+            gl->addWidget(new QLabel("Duration (s):"),2,2); gl->addWidget(netDuration,2,3);
+            gl->addWidget(netStack,3,0,1,4);
+            netStack->addWidget(new QWidget);   // iperf3: server IP + extra args above
+
+            QWidget* tp = new QWidget; QGridLayout* tl = new QGridLayout(tp); tl->setContentsMargins(0,0,0,0);
+            tcpStreams = new QSpinBox; tcpStreams->setRange(1,1024); tcpStreams->setValue(8);
+            tcpThreads = new QSpinBox; tcpThreads->setRange(1,256); tcpThreads->setValue(std::max(1, QThread::idealThreadCount()/2));
+            tcpPath    = new QComboBox; tcpPath->addItems({"all","write","sendfile","splice","zerocopy"});
+            tcpPath->setToolTip("\"all\" runs every send path in turn, splitting the duration between them");
+            tcpMsg     = new QLineEdit("128k");
+            tl->addWidget(new QLabel("Streams:"),0,0); tl->addWidget(tcpStreams,0,1);
+            tl->addWidget(new QLabel("Threads/side:"),0,2); tl->addWidget(tcpThreads,0,3);
+            tl->addWidget(new QLabel("Send path:"),1,0); tl->addWidget(tcpPath,1,1);
+            tl->addWidget(new QLabel("Message size:"),1,2); tl->addWidget(tcpMsg,1,3);
+            netStack->addWidget(tp);
+
+            QWidget* up = new QWidget; QGridLayout* ul = new QGridLayout(up); ul->setContentsMargins(0,0,0,0);
+            udpSizes   = new QLineEdit("64,128,256,512,1024,1472");
+            udpSizes->setToolTip("UDP payload sizes in bytes; 1472 fills a 1500-byte MTU. The duration is split across them.");
+            udpThreads = new QSpinBox; udpThreads->setRange(1,256); udpThreads->setValue(std::max(1, QThread::idealThreadCount()/2));
+            udpBatch   = new QSpinBox; udpBatch->setRange(1,1024); udpBatch->setValue(64);
+            udpBatch->setToolTip("Datagrams per sendmmsg()/recvmmsg() call");
+            ul->addWidget(new QLabel("Payload sizes:"),0,0); ul->addWidget(udpSizes,0,1,1,3);
+            ul->addWidget(new QLabel("Threads/side:"),1,0); ul->addWidget(udpThreads,1,1);
+            ul->addWidget(new QLabel("Batch:"),1,2); ul->addWidget(udpBatch,1,3);
+            netStack->addWidget(up);
+
+            QWidget* rp = new QWidget; QGridLayout* rl = new QGridLayout(rp); rl->setContentsMargins(0,0,0,0);
+            rttProto    = new QComboBox; rttProto->addItems({"both","tcp","udp"});
+            rttSizes    = new QLineEdit("64,1024,16384");
+            rttConns    = new QSpinBox; rttConns->setRange(1,4096); rttConns->setValue(1);
+            rttConns->setToolTip("Concurrent connections, one message in flight each");
+            rttBusyPoll = new QSpinBox; rttBusyPoll->setRange(0,1000); rttBusyPoll->setValue(0); rttBusyPoll->setSuffix(" us");
+            rttBusyPoll->setToolTip("SO_BUSY_POLL on both ends; 0 = off");
+            rl->addWidget(new QLabel("Protocol:"),0,0); rl->addWidget(rttProto,0,1);
+            rl->addWidget(new QLabel("Message sizes:"),0,2); rl->addWidget(rttSizes,0,3);
+            rl->addWidget(new QLabel("Connections:"),1,0); rl->addWidget(rttConns,1,1);
+            rl->addWidget(new QLabel("Busy poll:"),1,2); rl->addWidget(rttBusyPoll,1,3);
+            netStack->addWidget(rp);
+
+            QWidget* cr = new QWidget; QGridLayout* cl = new QGridLayout(cr); cl->setContentsMargins(0,0,0,0);
+            crClients   = new QSpinBox; crClients->setRange(1,4096); crClients->setValue(std::max(1, QThread::idealThreadCount()/2));
+            crAcceptors = new QSpinBox; crAcceptors->setRange(1,256); crAcceptors->setValue(std::max(1, QThread::idealThreadCount()/2));
+            crAcceptors->setToolTip("Acceptor threads, each with its own SO_REUSEPORT listener");
+            crBacklog   = new QSpinBox; crBacklog->setRange(1,65535); crBacklog->setValue(1024);
+            crLinger    = new QCheckBox("Close with RST (SO_LINGER 0)"); crLinger->setChecked(true);
+            crLinger->setToolTip("Avoids TIME_WAIT exhausting the ephemeral port range during long storms");
+            cl->addWidget(new QLabel("Client threads:"),0,0); cl->addWidget(crClients,0,1);
+            cl->addWidget(new QLabel("Acceptors:"),0,2); cl->addWidget(crAcceptors,0,3);
+            cl->addWidget(new QLabel("Listen backlog:"),1,0); cl->addWidget(crBacklog,1,1);
+            cl->addWidget(crLinger,1,2,1,2);
+            netStack->addWidget(cr);
+            auto syncEngine = [this, netStack](){
+                netStack->setCurrentIndex(netEngine->currentIndex());
+                netExtra->setEnabled(netEngine->currentIndex() == NetIperf);
+                netDuration->setEnabled(netEngine->currentIndex() != NetIperf);
+            };
+            connect(netEngine,&QComboBox::currentIndexChanged,this,syncEngine);
+            syncEngine();
             netOpts=f;
         }
         for (auto* w : {cpuOpts,ramOpts,gpuOpts,diskOpts,netOpts}) optsStack->addWidget(w);
@@ -376,6 +4427,8 @@ private:
         eta = new QLabel("ETA: --:--");
         ph->addWidget(eta);
         topv->addWidget(prog);
+        latency = new QLabel("Latency: --");
+        topv->addWidget(latency);
 
         grid->addWidget(top,0,0);
 
@@ -386,13 +4439,105 @@ private:
         gCpu = new DonutGauge; gCpu->setLabel("CPU");    gCpu->setArcColor(QColor("#84cc16"));
         gMem = new DonutGauge; gMem->setLabel("MEMORY"); gMem->setArcColor(QColor("#f59e0b"));
         gDsk = new DonutGauge; gDsk->setLabel("DISK");   gDsk->setArcColor(QColor("#e11d48"));
-        dh->addWidget(gCpu); dh->addWidget(gMem); dh->addWidget(gDsk);
+        gCores = new CoreStripWidget; gCores->setLabel("CORES");
+        gCores->setToolTip("Per-core utilization over the last two minutes (top row = cpu0)");
+        dh->addWidget(gCpu); dh->addWidget(gCores); dh->addWidget(gMem); dh->addWidget(gDsk);
         dh->addStretch(1);
         grid->addWidget(dash,1,0);
 
-        // ===== Row 2: Output =====
+        // ===== Row 2: Output / results =====
         output = new QTextEdit; output->setReadOnly(true);
-        grid->addWidget(output,2,0);
+        tabs = new QTabWidget;
+        tabs->addTab(output, "Output");
+        {
+            matrixTab = new QWidget; QHBoxLayout* mh = new QHBoxLayout(matrixTab);
+            const QStringList rows {"4k","16k","64k","256k","1m","4m"};
+            const QStringList cols {"0","30","50","70","100","0","30","50","70","100"};
+            const QStringList groups {"sequential (read %)","random (read %)"};
+            heatBw  = new HeatmapWidget; heatBw->setTitle("Throughput (MiB/s)");
+            heatP99 = new HeatmapWidget; heatP99->setTitle("p99 latency");
+            heatP99->setLowerIsBetter(true);
+            heatP99->setFormatter([](double ns){ return fmtNs(ns); });
+            for (auto* h : {heatBw,heatP99}) { h->setAxes(rows, cols, groups); mh->addWidget(h,1); }
+            tabs->addTab(matrixTab, "Disk Matrix");
+        }
+        {
+            netTab = new QWidget; QGridLayout* ng = new QGridLayout(netTab);
+            chartBps  = new TimeSeriesWidget; chartBps->setTitle("Throughput");
+            chartBps->setFormatter([](double bps){ return QString("%1 Gb/s").arg(bps/1e9, 0, 'f', 1); });
+            chartRetr = new TimeSeriesWidget; chartRetr->setTitle("Retransmits / lost packets per interval");
+            chartCwnd = new TimeSeriesWidget; chartCwnd->setTitle("Congestion window (sum of streams)");
+            chartCwnd->setFormatter([](double b){ return QString("%1 KiB").arg(b/1024, 0, 'f', 0); });
+            chartRtt  = new TimeSeriesWidget; chartRtt->setTitle("RTT (mean of streams)");
+            chartRtt->setFormatter([](double us){ return fmtNs(us*1e3); });
+            chartBps->addSeries("throughput", QColor("#2563eb"));
+            chartRetr->addSeries("retransmits", QColor("#dc2626"));
+            chartCwnd->addSeries("cwnd", QColor("#16a34a"));
+            chartRtt->addSeries("rtt", QColor("#9333ea"));
+            ng->addWidget(chartBps,0,0); ng->addWidget(chartRetr,0,1);
+            ng->addWidget(chartCwnd,1,0); ng->addWidget(chartRtt,1,1);
+            tabs->addTab(netTab, "Network");
+        }
+        {
+            gpuTab = new QWidget; QHBoxLayout* gh = new QHBoxLayout(gpuTab);
+            gpuTable = new QTableWidget(0, 4);
+            gpuTable->setHorizontalHeaderLabels({"Scene","Options","FPS","Frame time (ms)"});
+            gpuTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+            gpuTable->verticalHeader()->setVisible(false);
+            chartFps   = new TimeSeriesWidget; chartFps->setTitle("FPS per scene");
+            chartFrame = new TimeSeriesWidget; chartFrame->setTitle("Frame time per scene");
+            chartFrame->setFormatter([](double ms){ return QString("%1 ms").arg(ms, 0, 'f', 2); });
+            chartFps->addSeries("fps", QColor("#2563eb"));
+            chartFrame->addSeries("frame time", QColor("#dc2626"));
+            QVBoxLayout* gc = new QVBoxLayout;
+            for (auto* c : {chartFps,chartFrame}) { c->setXUnit("scenes"); gc->addWidget(c); }
+            gh->addWidget(gpuTable,3); gh->addLayout(gc,2);
+            tabs->addTab(gpuTab, "GPU");
+        }
+        {
+            fioTab = new QWidget; QGridLayout* fg = new QGridLayout(fioTab);
+            chartIops  = new TimeSeriesWidget; chartIops->setTitle("IOPS");
+            chartIops->setFormatter([](double v){ return QString("%1k").arg(v/1e3, 0, 'f', 1); });
+            chartFioBw = new TimeSeriesWidget; chartFioBw->setTitle("Bandwidth");
+            chartFioBw->setFormatter([](double b){ return QString("%1 MiB/s").arg(b/1048576.0, 0, 'f', 0); });
+            chartClat  = new TimeSeriesWidget; chartClat->setTitle("Completion latency (since start)");
+            chartClat->setFormatter([](double ns){ return fmtNs(ns); });
+            chartUtil  = new TimeSeriesWidget; chartUtil->setTitle("Device utilization");
+            chartUtil->setFormatter([](double v){ return QString("%1%").arg(v, 0, 'f', 0); });
+            for (auto* c : {chartIops,chartFioBw}) { c->addSeries("read", QColor("#2563eb")); c->addSeries("write", QColor("#dc2626")); }
+            chartClat->addSeries("read p50", QColor("#93c5fd")); chartClat->addSeries("read p99", QColor("#2563eb"));
+            chartClat->addSeries("write p50", QColor("#fca5a5")); chartClat->addSeries("write p99", QColor("#dc2626"));
+            chartUtil->addSeries("util", QColor("#16a34a"));
+            fg->addWidget(chartIops,0,0); fg->addWidget(chartFioBw,0,1);
+            fg->addWidget(chartClat,1,0); fg->addWidget(chartUtil,1,1);
+            tabs->addTab(fioTab, "Disk Series");
+        }
+        {
+            // Dashboard history from the time-series store (raw, or 10 s / 1 min / 10 min rollups)
+            sysTab = new QWidget; QVBoxLayout* sv = new QVBoxLayout(sysTab);
+            QHBoxLayout* sh = new QHBoxLayout;
+            sysWindow = new QComboBox;
+            sysWindow->addItem("Last 5 minutes", 300); sysWindow->addItem("Last hour", 3600);
+            sysWindow->addItem("Last 24 hours", 86400); sysWindow->addItem("Last 72 hours", 259200);
+            sh->addWidget(new QLabel("Window:")); sh->addWidget(sysWindow); sh->addStretch(1);
+            sv->addLayout(sh);
+            chartSysUtil  = new TimeSeriesWidget; chartSysUtil->setTitle("Utilization");
+            chartSysStall = new TimeSeriesWidget; chartSysStall->setTitle("Stall time (PSI)");
+            for (auto* c : {chartSysUtil,chartSysStall}) {
+                c->setFormatter([](double v){ return QString("%1%").arg(v, 0, 'f', 0); });
+                sv->addWidget(c, 1);
+            }
+            chartSysUtil->addSeries("cpu avg", QColor("#84cc16"));
+            chartSysUtil->addSeries("cpu max", QColor("#d9f99d"));
+            chartSysUtil->addSeries("memory", QColor("#f59e0b"));
+            chartSysStall->addSeries("cpu", QColor("#84cc16"));
+            chartSysStall->addSeries("io", QColor("#e11d48"));
+            chartSysStall->addSeries("memory", QColor("#f59e0b"));
+            connect(sysWindow,&QComboBox::currentIndexChanged,this,[this](int){ refreshHistoryCharts(); });
+            connect(tabs,&QTabWidget::currentChanged,this,[this](int){ refreshHistoryCharts(); });
+            tabs->addTab(sysTab, "System");
+        }
+        grid->addWidget(tabs,2,0);
         grid->setRowStretch(2,1);
 
         setCentralWidget(central);
@@ -440,6 +4585,11 @@ private:
             g->setTextColor(Qt::black);        // per your request: black text
             g->setCaptionColor(Qt::black);
         }
+        gCores->setTrackColor(track); gCores->setTextColor(Qt::black);
+        for (auto* h : {heatBw,heatP99}) h->setTextColor(text);
+        for (auto* c : {chartBps,chartRetr,chartCwnd,chartRtt,chartIops,chartFioBw,chartClat,chartUtil,chartFps,chartFrame,
+                        chartSysUtil,chartSysStall})
+            c->setTextColor(text);
         output->setStyleSheet(QString("QTextEdit{background:%1; color:%2;}").arg(
                                   (base==QColor("#1f2937"))?"#0f172a":"#ffffff",
                                   (base==QColor("#1f2937"))?"#E5E7EB":"#111827"));
@@ -456,17 +4606,88 @@ private:
 
     // --- Dashboard updates ---
     void updateDashboard() {
-        // CPU
-        double c = cpuPercent();
-        gCpu->setValue(c/100.0, ""); // keep caption blank to avoid clutter
+        // Drain everything the sampler produced since the last refresh; gauges show the newest
+        // while CPU and the per-core strip are averaged over all of them: at high
+        // rates a single /proc/stat delta spans only a few scheduler ticks
+        SysSample s; int n = 0;
+        double cpuSum = 0, stallSum[3] = {0, 0, 0};
+        std::array<float, CpuMeter::kMaxCores> coreSum{};
+        for (SysSample next; sampler.pop(next); ++n) {
+            s = next;
+            cpuSum += s.cpu;
+            stallSum[0] += std::max(0.0, s.cpuStall); stallSum[1] += std::max(0.0, s.ioStall); stallSum[2] += std::max(0.0, s.memStall);
+            for (int c = 0; c < s.cores; ++c) coreSum[size_t(c)] += s.core[size_t(c)];
+        }
+        if (!n) return;
+
+        // CPU; the caption shows time stalled waiting for a CPU (PSI) where the kernel reports it
+        gCpu->setValue(cpuSum/n/100.0, s.cpuStall < 0 ? QString() : QString("stall %1%").arg(stallSum[0]/n, 0, 'f', 1));
+        gCpu->setToolTip(QString("Sampling at %1 Hz; I/O stall %2%, memory stall %3%%4")
+                             .arg(sampler.rateHz()).arg(stallSum[1]/n, 0, 'f', 1).arg(stallSum[2]/n, 0, 'f', 1)
+                             .arg(sampler.dropped() ? QString("; %1 samples dropped").arg(sampler.dropped()) : QString()));
+        for (int c = 0; c < s.cores; ++c) coreSum[size_t(c)] /= 100.0f * n;
+        gCores->appendColumn(coreSum.data(), s.cores);
 
         // Mem
-        double u=0,t=0; double mp = memPercent(&u,&t);
-        gMem->setValue(mp/100.0, QString("%1 GiB / %2 GiB").arg(QString::number(u,'f',1), QString::number(t,'f',1)));
+        gMem->setValue(s.mem/100.0, QString("%1 GiB / %2 GiB").arg(QString::number(s.memUsedGiB,'f',1), QString::number(s.memTotalGiB,'f',1)));
 
         // Disk
-        double ud=0,td=0; double dp = rootDiskPercent(&ud,&td);
-        gDsk->setValue(dp/100.0, QString("%1 GiB / %2 GiB").arg(QString::number(ud,'f',1), QString::number(td,'f',1)));
+        gDsk->setValue(s.disk/100.0, QString("%1 GiB / %2 GiB").arg(QString::number(s.diskUsedGiB,'f',1), QString::number(s.diskTotalGiB,'f',1)));
+
+        if (++dashTicks % 4 == 0) refreshHistoryCharts();
+    }
+
+    // Redraws the System tab from the store; x is time into the window
+    void refreshHistoryCharts() {
+        if (tabs->currentWidget() != sysTab) return;
+        const uint64_t now = monoNs(), span = uint64_t(sysWindow->currentData().toInt()) * 1000000000ull;
+        const auto pts = sampler.historyRange(now > span ? now - span : 0, now, 600);
+        for (auto* c : {chartSysUtil,chartSysStall}) c->clearPoints();
+        if (pts.empty()) return;
+        // Seconds for short windows, minutes for an hour, hours beyond
+        const double unit = span <= 300e9 ? 1e9 : span <= 3600e9 ? 60e9 : 3600e9;
+        const QString unitName = unit == 1e9 ? "s" : unit == 60e9 ? "min" : "h";
+        for (auto* c : {chartSysUtil,chartSysStall}) c->setXUnit(unitName);
+        for (const auto& p : pts) {
+            const double x = double(p.tNs - pts.front().tNs) / unit;
+            chartSysUtil->append(0, x, p.avg[MetricCpu]);
+            chartSysUtil->append(1, x, p.max[MetricCpu]);
+            chartSysUtil->append(2, x, p.avg[MetricMem]);
+            chartSysStall->append(0, x, p.avg[MetricCpuStall]);
+            chartSysStall->append(1, x, p.avg[MetricIoStall]);
+            chartSysStall->append(2, x, p.avg[MetricMemStall]);
+        }
+    }
+
+    // Every tier, oldest first: raw samples, then the 10 s / 1 min / 10 min rollups
+    void exportHistory() {
+        QString fn = QFileDialog::getSaveFileName(this,"Export Metrics History",
+                                                  logDirPath()+"/metrics_"+timestamp()+".csv",
+                                                  "CSV files (*.csv);;All files (*)");
+        if (fn.isEmpty()) return;
+        QFile f(fn);
+        if (!f.open(QIODevice::WriteOnly|QIODevice::Text)) {
+            QMessageBox::critical(this,"Export Error","Cannot write file.");
+            return;
+        }
+        // Monotonic sample times are mapped onto the wall clock through one anchor
+        const qint64 wallNowMs = QDateTime::currentMSecsSinceEpoch();
+        const uint64_t monoNow = monoNs();
+        QTextStream ts(&f);
+        ts << "resolution,time,samples";
+        for (const char* m : kSysMetricNames) ts << ',' << m << "_min," << m << "_max," << m << "_avg";
+        ts << '\n';
+        for (int tier = 0; tier < TimeSeriesStore::kTiers; ++tier) {
+            TimeSeriesStore::forEach(sampler.historyTier(tier), [&](const StorePoint& p) {
+                const qint64 wallMs = wallNowMs - qint64((monoNow - p.tNs) / 1000000);
+                ts << TimeSeriesStore::kTierNames[tier] << ','
+                   << QDateTime::fromMSecsSinceEpoch(wallMs).toString(Qt::ISODateWithMs) << ',' << p.n;
+                auto cell = [&](float v) { ts << ','; if (!std::isnan(v)) ts << v; };   // unavailable (no PSI) = empty
+                for (int m = 0; m < kSysMetrics; ++m) { cell(p.min[m]); cell(p.max[m]); cell(p.avg[m]); }
+                ts << '\n';
+            });
+        }
+        QMessageBox::information(this,"Export Metrics History", "Saved to:\n"+fn);
     }
 
     // --- Process handling ---
@@ -481,6 +4702,12 @@ private:
 
         // log file
         QString fn = QString("%1/%2_%3.log").arg(logDirPath(), testName(), timestamp());
+        stressYamlPath.clear();
+        if (cmd.first() == "stress-ng") {
+            // Per-stressor bogo-ops and CPU times, read back when the run ends
+            stressYamlPath = fn.chopped(4) + ".yaml";
+            cmd << "--metrics" << "--yaml" << stressYamlPath;
+        }
         logFile.setFileName(fn);
         if (!logFile.open(QIODevice::WriteOnly|QIODevice::Text)) {
             QMessageBox::critical(this, "Logging Error", "Cannot write log file: "+fn);
@@ -489,11 +4716,40 @@ private:
         QTextStream ts(&logFile);
         ts << APP_NAME << " Log - " << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n";
         ts << "Command: " << cmd.join(' ') << "\n\n"; ts.flush();
+        runRecordPath = fn.chopped(4) + ".json";
+        runRecord = QJsonObject{{"test", testName()}, {"command", cmd.join(' ')},
+                                {"started", QDateTime::currentDateTime().toString(Qt::ISODate)}};
+        stdoutBuf.clear();
+        latency->setText("Latency: --");
+        if (cmd.contains("--matrix")) {
+            for (auto* h : {heatBw,heatP99}) h->clearValues();
+            tabs->setCurrentWidget(matrixTab);
+        }
+        glmarkRun = cmd.contains("glmark2");
+        glmarkDone = 0; glRenderer.clear();
+        if (glmarkRun) {
+            gpuTable->setRowCount(0);
+            for (auto* c : {chartFps,chartFrame}) c->clearPoints();
+            tabs->setCurrentWidget(gpuTab);
+        }
+        jsonDoc.clear(); jsonDocOpen = false;
+        fioPrev = {}; fioLast = {};
+        jsonOut = cmd.contains("--output-format=json") ? JsonOut::FioDoc
+                : cmd.contains("--json-stream") ? JsonOut::IperfStream
+                : (cmd.contains("-J") || cmd.contains("--json")) ? JsonOut::IperfDoc : JsonOut::Off;
+        if (jsonOut == JsonOut::FioDoc) {
+            for (auto* c : {chartIops,chartFioBw,chartClat,chartUtil}) c->clearPoints();
+            tabs->setCurrentWidget(fioTab);
+        } else if (jsonOut != JsonOut::Off) {
+            for (auto* c : {chartBps,chartRetr,chartCwnd,chartRtt}) c->clearPoints();
+            tabs->setCurrentWidget(netTab);
+        }
 
         // UI state
         expectedSeconds.reset();
         if (exp.has_value()) expectedSeconds = *exp;
         runTimer.restart();
+        runStartNs = monoNs();
         btnStart->setEnabled(false);
         btnStop->setEnabled(true);
         progress->setMaximum(exp.has_value()? *exp : 0);
@@ -520,8 +4776,27 @@ private:
     }
 
     void procFinished(int rc, QProcess::ExitStatus) {
+        if (jsonOut == JsonOut::IperfDoc && !jsonDoc.isEmpty()) {
+            // -J: the whole report arrives at exit; replay it through the stream handler
+            QJsonObject doc = QJsonDocument::fromJson(jsonDoc).object();
+            QString shown = handleIperfEvent("start", doc.value("start").toObject());
+            for (const auto& iv : doc.value("intervals").toArray()) shown += handleIperfEvent("interval", iv.toObject());
+            shown += handleIperfEvent("end", doc.value("end").toObject());
+            if (doc.contains("error")) shown += "iperf3 error: " + doc.value("error").toString() + "\n";
+            output->moveCursor(QTextCursor::End); output->insertPlainText(shown); output->moveCursor(QTextCursor::End);
+            jsonDoc.clear();
+        }
+        if (!stressYamlPath.isEmpty()) {
+            output->moveCursor(QTextCursor::End); output->insertPlainText(stressNgMetrics(stressYamlPath)); output->moveCursor(QTextCursor::End);
+            stressYamlPath.clear();
+        }
+        if (jsonOut == JsonOut::FioDoc && !fioLast.isEmpty()) {
+            // The last status fio prints is its final report
+            output->moveCursor(QTextCursor::End); output->insertPlainText(fioSummary(fioLast)); output->moveCursor(QTextCursor::End);
+        }
         output->append(QString("\nProcess finished with return code: %1").arg(rc));
         if (logFile.isOpen()) { QTextStream(&logFile) << "\n[exit] " << rc << "\n"; logFile.close(); }
+        saveRunRecord(rc);
         btnStart->setEnabled(true);
         btnStop->setEnabled(false);
         statusBar()->showMessage("Ready.");
@@ -530,9 +4805,392 @@ private:
     }
 
     void readStdout() {
-        auto s = QString::fromLocal8Bit(proc.readAllStandardOutput());
-        output->moveCursor(QTextCursor::End); output->insertPlainText(s); output->moveCursor(QTextCursor::End);
-        if (logFile.isOpen()) { QTextStream(&logFile) << s; }
+        QByteArray chunk = proc.readAllStandardOutput();
+        if (logFile.isOpen()) { QTextStream(&logFile) << QString::fromLocal8Bit(chunk); }
+
+        // "@hst {json}" lines are records for us; everything else is shown as-is.
+        // Only a trailing partial line that may be a record is held back.
+        stdoutBuf.append(chunk);
+        QString shown;
+        int start = 0;
+        for (int nl; (nl = stdoutBuf.indexOf('\n', start)) >= 0; start = nl + 1) {
+            QByteArray line = stdoutBuf.mid(start, nl - start);
+            if (line.startsWith("@hst ")) handleRecord(line.mid(5));
+            else if (jsonOut == JsonOut::IperfStream && line.startsWith("{")) shown += iperfStreamLine(line);
+            else if ((jsonOut == JsonOut::IperfDoc || jsonOut == JsonOut::FioDoc) && (jsonDocOpen || line == "{")) {
+                jsonDoc += line + '\n';
+                jsonDocOpen = line != "}";
+                if (!jsonDocOpen && jsonOut == JsonOut::FioDoc) {
+                    shown += handleFioStatus(QJsonDocument::fromJson(jsonDoc).object());
+                    jsonDoc.clear();
+                }
+            }
+            else {
+                shown += QString::fromLocal8Bit(line) + '\n';
+                if (glmarkRun) shown += glmarkLine(QString::fromLocal8Bit(line));
+            }
+        }
+        stdoutBuf.remove(0, start);
+        const bool held = stdoutBuf.startsWith("@") || (jsonOut != JsonOut::Off && stdoutBuf.startsWith("{"));
+        if (!stdoutBuf.isEmpty() && !held && !jsonDocOpen) {
+            shown += QString::fromLocal8Bit(stdoutBuf);
+            stdoutBuf.clear();
+        }
+        if (!shown.isEmpty()) {
+            output->moveCursor(QTextCursor::End); output->insertPlainText(shown); output->moveCursor(QTextCursor::End);
+        }
+    }
+
+    void handleRecord(const QByteArray& json) {
+        QJsonObject r = QJsonDocument::fromJson(json).object();
+        const QString type = r.value("type").toString();
+        if (type == "lat") {
+            latency->setText(QString("Latency [%1]  p50 %2   p99 %3   p99.9 %4   p99.99 %5   max %6  (n=%7)")
+                             .arg(r.value("label").toString(), fmtNs(r.value("p50").toDouble()),
+                                  fmtNs(r.value("p99").toDouble()), fmtNs(r.value("p999").toDouble()),
+                                  fmtNs(r.value("p9999").toDouble()), fmtNs(r.value("max").toDouble()))
+                             .arg(qint64(r.value("count").toDouble())));
+        } else if (type == "cell") {
+            static const QList<int> sizes {4096,16384,65536,262144,1048576,4194304};
+            static const QList<int> mixes {0,30,50,70,100};
+            int row = sizes.indexOf(r.value("bs").toInt());
+            int col = mixes.indexOf(r.value("read").toInt());
+            if (col >= 0 && r.value("order").toString() == "rand") col += mixes.size();
+            heatBw->setValue(row, col, r.value("mibps").toDouble());
+            heatP99->setValue(row, col, r.value("p99").toDouble());
+            QJsonArray cells = runRecord.value("matrix").toArray();
+            r.remove("type");
+            cells.append(r);
+            runRecord["matrix"] = cells;
+        } else if (type == "progress") {
+            // Work-based progress, for runs without a fixed duration
+            if (!expectedSeconds.has_value()) {
+                double f = std::clamp(r.value("fraction").toDouble(), 0.0, 1.0);
+                progress->setRange(0,1000); progress->setValue(int(f*1000));
+                if (f > 0.01) setEta(int(runTimer.elapsed()/1000.0 * (1.0-f)/f));
+            }
+        } else if (type == "verify_error") {
+            QJsonArray es = runRecord.value("verify_errors").toArray();
+            r.remove("type");
+            es.append(r);
+            runRecord["verify_errors"] = es;
+        } else if (type == "result") {
+            QJsonArray rs = runRecord.value("results").toArray();
+            r.remove("type");
+            rs.append(r);
+            runRecord["results"] = rs;
+        } else if (type == "hist") {
+            QJsonArray hs = runRecord.value("histograms").toArray();
+            r.remove("type");
+            hs.append(r);
+            runRecord["histograms"] = hs;
+        }
+    }
+
+    // --- iperf3 JSON ---
+    QString iperfStreamLine(const QByteArray& line) {
+        QJsonParseError err{};
+        QJsonObject ev = QJsonDocument::fromJson(line, &err).object();
+        if (err.error != QJsonParseError::NoError) return QString::fromLocal8Bit(line) + '\n';
+        if (ev.value("event").toString() == "error") return "iperf3 error: " + ev.value("data").toString() + "\n";
+        return handleIperfEvent(ev.value("event").toString(), ev.value("data").toObject());
+    }
+
+    // Turns start / interval / end into chart points, run-record entries and a
+    // readable line for the Output tab.
+    QString handleIperfEvent(const QString& event, const QJsonObject& data) {
+        if (event == "start") {
+            QJsonObject ts = data.value("test_start").toObject();
+            int secs = ts.value("duration").toInt() + ts.value("omit").toInt();
+            if (secs > 0 && proc.state() != QProcess::NotRunning) expectedSeconds = secs;
+            QJsonArray conns = data.value("connected").toArray();
+            QJsonObject c = conns.isEmpty() ? QJsonObject() : conns.first().toObject();
+            runRecord["iperf_start"] = QJsonObject{{"version", data.value("version").toString()},
+                                                   {"protocol", ts.value("protocol").toString()},
+                                                   {"streams", ts.value("num_streams").toInt()},
+                                                   {"duration", ts.value("duration").toInt()},
+                                                   {"reverse", ts.value("reverse").toInt()}};
+            return QString("iperf3 %1: %2 -> %3:%4, %5, %6 stream(s), %7 s\n")
+                .arg(data.value("version").toString(), c.value("local_host").toString(),
+                     c.value("remote_host").toString()).arg(c.value("remote_port").toInt())
+                .arg(ts.value("protocol").toString()).arg(ts.value("num_streams").toInt()).arg(ts.value("duration").toInt());
+        }
+        if (event == "interval") {
+            QJsonObject sum = data.value("sum").toObject();
+            const double t = sum.value("end").toDouble();
+            const double bps = sum.value("bits_per_second").toDouble();
+            // TCP senders report retransmits and per-stream cwnd/rtt; UDP reports lost packets
+            const bool udp = sum.contains("lost_packets");
+            const double retr = udp ? sum.value("lost_packets").toDouble() : sum.value("retransmits").toDouble(std::nan(""));
+            double cwnd = 0, rtt = 0;
+            int rttN = 0;
+            for (const auto& sv : data.value("streams").toArray()) {
+                QJsonObject st = sv.toObject();
+                cwnd += st.value("snd_cwnd").toDouble();
+                if (st.contains("rtt")) { rtt += st.value("rtt").toDouble(); ++rttN; }
+            }
+            chartBps->append(0, t, bps);
+            chartRetr->append(0, t, retr);
+            if (cwnd > 0) chartCwnd->append(0, t, cwnd);
+            if (rttN) chartRtt->append(0, t, rtt / rttN);
+            QJsonObject iv {{"t", t}, {"bps", bps}, {"omitted", sum.value("omitted").toBool()}};
+            if (!std::isnan(retr)) iv[udp ? "lost_packets" : "retransmits"] = retr;
+            if (cwnd > 0) iv["cwnd_bytes"] = cwnd;
+            if (rttN) iv["rtt_us"] = rtt / rttN;
+            QJsonArray ivs = runRecord.value("iperf_intervals").toArray();
+            ivs.append(iv);
+            runRecord["iperf_intervals"] = ivs;
+            QString line = QString("[%1 - %2 s]  %3 Gbit/s").arg(sum.value("start").toDouble(), 5, 'f', 1)
+                               .arg(t, 5, 'f', 1).arg(bps/1e9, 7, 'f', 2);
+            if (!std::isnan(retr)) line += QString("  %1 %2").arg(udp ? "lost" : "retr").arg(qint64(retr));
+            if (cwnd > 0) line += QString("  cwnd %1 KiB").arg(cwnd/1024, 0, 'f', 0);
+            if (rttN) line += "  rtt " + fmtNs(rtt / rttN * 1e3);
+            return line + '\n';
+        }
+        if (event == "end") {
+            QJsonObject sent = data.value("sum_sent").toObject(), recv = data.value("sum_received").toObject();
+            if (sent.isEmpty()) sent = recv = data.value("sum").toObject();   // UDP
+            QJsonObject cpu = data.value("cpu_utilization_percent").toObject();
+            QJsonObject r {{"label", "iperf3"}, {"sent_bps", sent.value("bits_per_second").toDouble()},
+                           {"received_bps", recv.value("bits_per_second").toDouble()},
+                           {"cpu_host_pct", cpu.value("host_total").toDouble()},
+                           {"cpu_remote_pct", cpu.value("remote_total").toDouble()}};
+            if (sent.contains("retransmits")) r["retransmits"] = sent.value("retransmits").toDouble();
+            if (sent.contains("lost_percent")) r["lost_pct"] = sent.value("lost_percent").toDouble();
+            QJsonArray rs = runRecord.value("results").toArray();
+            rs.append(r);
+            runRecord["results"] = rs;
+            return QString("summary: sent %1 Gbit/s, received %2 Gbit/s%3, CPU host %4% / remote %5%\n")
+                .arg(r.value("sent_bps").toDouble()/1e9, 0, 'f', 2).arg(r.value("received_bps").toDouble()/1e9, 0, 'f', 2)
+                .arg(r.contains("retransmits") ? QString(", %1 retransmits").arg(qint64(r.value("retransmits").toDouble())) : QString())
+                .arg(r.value("cpu_host_pct").toDouble(), 0, 'f', 1).arg(r.value("cpu_remote_pct").toDouble(), 0, 'f', 1);
+        }
+        return {};
+    }
+
+    // --- fio JSON ---
+    static double fioPct(const QJsonObject& dir, const char* key) {
+        return dir.value("clat_ns").toObject().value("percentile").toObject().value(key).toDouble(std::nan(""));
+    }
+
+    // One status document per --status-interval; totals are cumulative since start.
+    QString handleFioStatus(const QJsonObject& doc) {
+        QJsonArray jobs = doc.value("jobs").toArray();
+        if (jobs.isEmpty()) return {};
+        fioLast = doc;
+        FioTotals cur;
+        double rP50 = 0, rP99 = 0, wP50 = 0, wP99 = 0;
+        for (const auto& jv : jobs) {
+            QJsonObject j = jv.toObject(), r = j.value("read").toObject(), w = j.value("write").toObject();
+            cur.t = std::max(cur.t, j.value("elapsed").toDouble());
+            cur.readBytes += r.value("io_bytes").toDouble(); cur.writeBytes += w.value("io_bytes").toDouble();
+            cur.readIos += r.value("total_ios").toDouble();  cur.writeIos += w.value("total_ios").toDouble();
+            // Worst job per percentile; NaN (no I/O in that direction) is skipped by fmax
+            rP50 = std::fmax(rP50, fioPct(r, "50.000000")); rP99 = std::fmax(rP99, fioPct(r, "99.000000"));
+            wP50 = std::fmax(wP50, fioPct(w, "50.000000")); wP99 = std::fmax(wP99, fioPct(w, "99.000000"));
+        }
+        const double dt = cur.t - fioPrev.t;
+        if (dt <= 0) return {};
+        const double rIops = (cur.readIos - fioPrev.readIos) / dt, wIops = (cur.writeIos - fioPrev.writeIos) / dt;
+        const double rBw = (cur.readBytes - fioPrev.readBytes) / dt, wBw = (cur.writeBytes - fioPrev.writeBytes) / dt;
+        fioPrev = cur;
+        double util = 0;
+        for (const auto& dv : doc.value("disk_util").toArray()) util = std::max(util, dv.toObject().value("util").toDouble());
+
+        chartIops->append(0, cur.t, rIops);  chartIops->append(1, cur.t, wIops);
+        chartFioBw->append(0, cur.t, rBw);   chartFioBw->append(1, cur.t, wBw);
+        if (cur.readIos > 0)  { chartClat->append(0, cur.t, rP50); chartClat->append(1, cur.t, rP99); }
+        if (cur.writeIos > 0) { chartClat->append(2, cur.t, wP50); chartClat->append(3, cur.t, wP99); }
+        if (doc.contains("disk_util")) chartUtil->append(0, cur.t, util);
+
+        QJsonObject iv {{"t", cur.t}, {"read_iops", rIops}, {"write_iops", wIops},
+                        {"read_bw", rBw}, {"write_bw", wBw}};
+        if (cur.readIos > 0)  { iv["read_p50_ns"] = rP50; iv["read_p99_ns"] = rP99; }
+        if (cur.writeIos > 0) { iv["write_p50_ns"] = wP50; iv["write_p99_ns"] = wP99; }
+        if (doc.contains("disk_util")) iv["util_pct"] = util;
+        QJsonArray ivs = runRecord.value("fio_intervals").toArray();
+        ivs.append(iv);
+        runRecord["fio_intervals"] = ivs;
+
+        return QString("[%1 s]  read %2 IOPS %3 MiB/s  write %4 IOPS %5 MiB/s\n").arg(cur.t, 5, 'f', 0)
+            .arg(rIops, 9, 'f', 0).arg(rBw/1048576.0, 8, 'f', 1).arg(wIops, 9, 'f', 0).arg(wBw/1048576.0, 8, 'f', 1);
+    }
+
+    // Final report: one result row per job and direction, plus the raw document
+    QString fioSummary(const QJsonObject& doc) {
+        QJsonArray rs = runRecord.value("results").toArray();
+        QString shown = "\nfio summary:\n";
+        for (const auto& jv : doc.value("jobs").toArray()) {
+            QJsonObject j = jv.toObject();
+            for (const char* dirName : {"read", "write"}) {
+                QJsonObject d = j.value(dirName).toObject();
+                if (d.value("total_ios").toDouble() <= 0) continue;
+                QJsonObject r {{"label", j.value("jobname").toString() + " " + dirName},
+                               {"iops", d.value("iops").toDouble()}, {"bw_bytes", d.value("bw_bytes").toDouble()},
+                               {"clat_mean_ns", d.value("clat_ns").toObject().value("mean").toDouble()}};
+                for (auto [key, pct] : {std::pair{"p50_ns", "50.000000"}, {"p99_ns", "99.000000"},
+                                        {"p99.9_ns", "99.900000"}, {"p99.99_ns", "99.990000"}}) {
+                    const double v = fioPct(d, pct);
+                    if (!std::isnan(v)) r[key] = v;
+                }
+                rs.append(r);
+                auto pct = [&](const char* k) { return r.contains(k) ? fmtNs(r.value(k).toDouble()) : QString("-"); };
+                shown += QString("  %1 %2: %3 IOPS, %4 MiB/s, p50 %5, p99 %6, p99.9 %7\n")
+                    .arg(j.value("jobname").toString(), dirName).arg(r.value("iops").toDouble(), 0, 'f', 0)
+                    .arg(r.value("bw_bytes").toDouble()/1048576.0, 0, 'f', 1)
+                    .arg(pct("p50_ns"), pct("p99_ns"), pct("p99.9_ns"));
+            }
+        }
+        runRecord["results"] = rs;
+        runRecord["fio"] = doc;
+        return shown;
+    }
+
+    // --- glmark2 ---
+    // "[build] use-vbo=false: FPS: 1234 FrameTime: 0.810 ms", "[scene] opts: Unsupported",
+    // "GL_RENDERER: llvmpipe (...)" and finally "glmark2 Score: 1234".
+    QString glmarkLine(const QString& line) {
+        static const QRegularExpression sceneRe("^\\[([^\\]]+)\\]\\s*(.*):\\s*FPS:\\s*([\\d.]+)\\s*FrameTime:\\s*([\\d.]+)\\s*ms");
+        static const QRegularExpression skipRe("^\\[([^\\]]+)\\]\\s*(.*):\\s*(Unsupported|Set up failed)");
+        static const QRegularExpression scoreRe("glmark2 Score:\\s*(\\d+)");
+        if (line.trimmed().startsWith("GL_RENDERER:")) {
+            glRenderer = line.section(':', 1).trimmed();
+            runRecord["gl_renderer"] = glRenderer;
+            return {};
+        }
+        if (auto m = scoreRe.match(line); m.hasMatch()) return glmarkScore(m.captured(1).toInt());
+        auto m = sceneRe.match(line);
+        const bool ran = m.hasMatch();
+        if (!ran) { m = skipRe.match(line); if (!m.hasMatch()) return {}; }
+        ++glmarkDone;
+        // The suite's length is known, the per-scene time is not: extrapolate from the scenes done
+        const int elapsed = int(runTimer.elapsed() / 1000);
+        if (elapsed > 0) expectedSeconds = std::max(elapsed, elapsed * std::max(kGlmarkScenes, glmarkDone + 1) / glmarkDone);
+
+        const int row = gpuTable->rowCount();
+        gpuTable->insertRow(row);
+        gpuTable->setItem(row, 0, new QTableWidgetItem(m.captured(1)));
+        gpuTable->setItem(row, 1, new QTableWidgetItem(m.captured(2)));
+        gpuTable->setItem(row, 2, new QTableWidgetItem(m.captured(3)));
+        gpuTable->setItem(row, 3, new QTableWidgetItem(ran ? m.captured(4) : QString("-")));
+        if (!ran) return {};
+        chartFps->append(0, glmarkDone, m.captured(3).toDouble());
+        chartFrame->append(0, glmarkDone, m.captured(4).toDouble());
+        QJsonArray rs = runRecord.value("results").toArray();
+        rs.append(QJsonObject{{"label", m.captured(1) + " " + m.captured(2)}, {"fps", m.captured(3).toDouble()},
+                              {"frame_ms", m.captured(4).toDouble()}});
+        runRecord["results"] = rs;
+        return {};
+    }
+
+    // Scores are appended to a per-host history so runs (and renderers) can be compared
+    QString glmarkScore(int score) {
+        runRecord["glmark2_score"] = score;
+        const QString renderer = glRenderer.isEmpty() ? QString("unknown") : glRenderer;
+        QFile hist(logDirPath() + "/glmark2_scores.tsv");
+        int previous = 0;
+        if (hist.open(QIODevice::ReadOnly|QIODevice::Text)) {
+            while (!hist.atEnd()) {
+                const QStringList f = QString::fromUtf8(hist.readLine()).trimmed().split('\t');
+                if (f.size() >= 3 && f[1] == renderer) previous = f[2].toInt();
+            }
+            hist.close();
+        }
+        if (hist.open(QIODevice::Append|QIODevice::Text))
+            QTextStream(&hist) << timestamp() << '\t' << renderer << '\t' << score << '\n';
+        QString msg = QString("glmark2 score %1 on %2").arg(score).arg(renderer);
+        if (previous > 0) {
+            msg += QString(" (previous run: %1, %2%3%)").arg(previous).arg(score >= previous ? "+" : "")
+                       .arg(100.0 * (score - previous) / previous, 0, 'f', 1);
+            runRecord["glmark2_previous_score"] = previous;
+        }
+        return msg + '\n';
+    }
+
+    // --- stress-ng metrics ---
+    // The --yaml report is flat enough to read line by line: top-level sections
+    // ("system-info:", "metrics:", "times:") hold "key: value" pairs, and each
+    // "- stressor: name" entry under metrics starts a new stressor.
+    QString stressNgMetrics(const QString& path) {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly|QIODevice::Text)) return QString("\nstress-ng metrics: cannot read %1\n").arg(path);
+        QJsonArray metrics;
+        QJsonObject times, sysInfo, cur;
+        QString section;
+        auto value = [](const QString& v) -> QJsonValue {
+            bool ok = false; const double d = v.toDouble(&ok);
+            return ok ? QJsonValue(d) : QJsonValue(v);
+        };
+        while (!f.atEnd()) {
+            QString line = QString::fromUtf8(f.readLine());
+            line.chop(line.endsWith("\n") ? 1 : 0);
+            if (line.trimmed().isEmpty() || line.startsWith("---") || line.startsWith("...") || line.trimmed().startsWith("#")) continue;
+            if (!line.startsWith(" ") && !line.startsWith("-")) { section = line.section(':', 0, 0); continue; }
+            QString t = line.trimmed();
+            const bool item = t.startsWith("- ");
+            if (item) t = t.mid(2);
+            const int colon = t.indexOf(':');
+            if (colon <= 0) continue;
+            const QString key = t.left(colon).trimmed(), val = t.mid(colon + 1).trimmed();
+            if (section == "metrics") {
+                if (item && !cur.isEmpty()) { metrics.append(cur); cur = {}; }
+                cur[key] = value(val);
+            } else if (section == "times") {
+                times[key] = value(val);
+            } else if (section == "system-info") {
+                sysInfo[key] = value(val);
+            }
+        }
+        if (!cur.isEmpty()) metrics.append(cur);
+        if (metrics.isEmpty()) return "\nstress-ng metrics: no per-stressor results in " + path + "\n";
+
+        runRecord["stress_ng"] = QJsonObject{{"metrics", metrics}, {"times", times}, {"system_info", sysInfo}, {"yaml", path}};
+        QJsonArray rs = runRecord.value("results").toArray();
+        QString shown = QString("\n%1 %2 %3 %4 %5 %6 %7\n").arg("stressor", -16).arg("bogo ops", 12)
+                            .arg("ops/s real", 12).arg("ops/s u+s", 12).arg("real s", 8).arg("usr s", 8).arg("sys s", 8);
+        for (const auto& mv : metrics) {
+            QJsonObject m = mv.toObject();
+            QJsonObject r {{"label", m.value("stressor").toString()},
+                           {"bogo_ops", m.value("bogo-ops").toDouble()},
+                           {"bogo_ops_s_real", m.value("bogo-ops-per-second-real-time").toDouble()},
+                           {"bogo_ops_s_usr_sys", m.value("bogo-ops-per-second-usr-sys-time").toDouble()},
+                           {"real_s", m.value("wall-clock-time").toDouble()},
+                           {"usr_s", m.value("user-time").toDouble()},
+                           {"sys_s", m.value("system-time").toDouble()}};
+            if (m.contains("cpu-usage-per-instance")) r["cpu_pct_per_instance"] = m.value("cpu-usage-per-instance").toDouble();
+            if (m.contains("max-rss")) r["max_rss_kib"] = m.value("max-rss").toDouble();
+            rs.append(r);
+            shown += QString("%1 %2 %3 %4 %5 %6 %7\n").arg(r.value("label").toString(), -16)
+                         .arg(r.value("bogo_ops").toDouble(), 12, 'f', 0)
+                         .arg(r.value("bogo_ops_s_real").toDouble(), 12, 'f', 1)
+                         .arg(r.value("bogo_ops_s_usr_sys").toDouble(), 12, 'f', 1)
+                         .arg(r.value("real_s").toDouble(), 8, 'f', 2)
+                         .arg(r.value("usr_s").toDouble(), 8, 'f', 2)
+                         .arg(r.value("sys_s").toDouble(), 8, 'f', 2);
+        }
+        runRecord["results"] = rs;
+        return shown;
+    }
+
+    void saveRunRecord(int rc) {
+        if (runRecordPath.isEmpty()) return;
+        runRecord["finished"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        runRecord["exit"] = rc;
+        // Host metrics over the run, at most 500 points whatever its length
+        QJsonArray t, cpuAvg, cpuMax, mem, cpuStall, ioStall, memStall;
+        auto num = [](float v) { return std::isnan(v) ? QJsonValue() : QJsonValue(double(v)); };
+        for (const auto& p : sampler.historyRange(runStartNs, monoNs(), 500)) {
+            t.append(double(p.tNs - runStartNs) / 1e9);
+            cpuAvg.append(num(p.avg[MetricCpu])); cpuMax.append(num(p.max[MetricCpu]));
+            mem.append(num(p.avg[MetricMem]));
+            cpuStall.append(num(p.avg[MetricCpuStall])); ioStall.append(num(p.avg[MetricIoStall]));
+            memStall.append(num(p.avg[MetricMemStall]));
+        }
+        runRecord["system"] = QJsonObject{{"t", t}, {"cpu_avg", cpuAvg}, {"cpu_max", cpuMax}, {"mem", mem},
+                                          {"cpu_stall", cpuStall}, {"io_stall", ioStall}, {"mem_stall", memStall}};
+        QFile f(runRecordPath);
+        if (f.open(QIODevice::WriteOnly|QIODevice::Text)) f.write(QJsonDocument(runRecord).toJson());
+        runRecordPath.clear();
     }
     void readStderr() {
         auto s = QString::fromLocal8Bit(proc.readAllStandardError());
@@ -546,14 +5204,131 @@ private:
                 int elapsed = int(runTimer.elapsed()/1000.0);
                 progress->setMaximum(*expectedSeconds);
                 progress->setValue(std::min(*expectedSeconds, std::max(0, elapsed)));
-                int remain = std::max(0, *expectedSeconds - elapsed);
-                int mm = remain/60, ss = remain%60;
-                eta->setText(QString("ETA: %1:%2").arg(mm,2,10,QChar('0')).arg(ss,2,10,QChar('0')));
+                setEta(std::max(0, *expectedSeconds - elapsed));
             }
             QTimer::singleShot(200, this, &MainWindow::tickProgress);
         }
     }
 
+    void setEta(int remain) {
+        int mm = remain/60, ss = remain%60;
+        eta->setText(QString("ETA: %1:%2").arg(mm,2,10,QChar('0')).arg(ss,2,10,QChar('0')));
+    }
+
+    // --- Block devices ---
+    void scanBlockDevices() {
+        QStringList ticked = selectedDevices();
+        diskDevices->clear();
+        for (const auto& d : listBlockDevices()) {
+            QString type = d.loop ? "loop" : d.rotational ? "hdd" : "ssd";
+            QString text = QString("%1%2  %3 GiB  %4  QD %5  %6  %7")
+                .arg(d.parent.empty() ? "" : "  └ ", QString::fromStdString(d.name))
+                .arg(d.size / 1073741824.0, 0, 'f', 1).arg(type).arg(d.queueDepth)
+                .arg(QString::fromStdString(d.scheduler), QString::fromStdString(d.model));
+            if (d.mounted) text += "  (mounted)";
+            if (d.held) text += "  (in use)";
+            auto* it = new QListWidgetItem(text, diskDevices);
+            const QString path = QString::fromStdString(d.path);
+            it->setData(Qt::UserRole, path);
+            it->setData(Qt::UserRole+1, d.loop);
+            it->setData(Qt::UserRole+2, d.mounted || d.held);
+            it->setFlags(it->flags() | Qt::ItemIsUserCheckable);
+            it->setCheckState(ticked.contains(path) ? Qt::Checked : Qt::Unchecked);
+        }
+    }
+    QStringList selectedDevices() const {
+        QStringList out;
+        for (int i = 0; i < diskDevices->count(); ++i)
+            if (diskDevices->item(i)->checkState() == Qt::Checked) out << diskDevices->item(i)->data(Qt::UserRole).toString();
+        return out;
+    }
+    // Raw (non-loop) devices are read-only unless explicitly allowed; mounted or held ones always are
+    bool devicesWritable() const {
+        for (int i = 0; i < diskDevices->count(); ++i) {
+            auto* it = diskDevices->item(i);
+            if (it->checkState() != Qt::Checked) continue;
+            if (it->data(Qt::UserRole+2).toBool()) return false;
+            if (!it->data(Qt::UserRole+1).toBool() && !diskRawWrite->isChecked()) return false;
+        }
+        return true;
+    }
+
+    // stress-ng answers "--stressors" with one line of names, "--class ?" with
+    // "... must be one of: a b c" and "--class a?" with "class 'a' stressors: x y".
+    // Per-stressor options are the "--<name>-..." lines of "--help". The queries
+    // run as background processes (the per-class ones in parallel), so the
+    // window is up at once and the list fills in when the last one answers.
+    struct StressorScan {
+        QStringList names, classes;
+        QMap<QString, QStringList> classesOf;
+        QString help;
+        int pending = 0;
+    };
+    static QStringList stressNgWords(const QString& out) {
+        const QString last = out.trimmed().split('\n').value(0).section(':', -1);
+        return last.split(' ', Qt::SkipEmptyParts);
+    }
+    void scanStressors() {
+        const int gen = ++stressScanGen;
+        cpuOptHelp->setText("Scanning stress-ng stressors...");
+        toolOutputAsync(this, "stress-ng", {"--stressors"}, [this, gen](const QString& out) {
+            if (gen != stressScanGen) return;
+            auto scan = std::make_shared<StressorScan>();
+            scan->names = out.trimmed().split(' ', Qt::SkipEmptyParts);
+            if (scan->names.isEmpty()) { fillStressors(*scan); return; }
+            toolOutputAsync(this, "stress-ng", {"--class", "?"}, [this, gen, scan](const QString& out) {
+                if (gen != stressScanGen) return;
+                scan->classes = stressNgWords(out);
+                scan->pending = int(scan->classes.size()) + 1;
+                auto landed = [this, gen, scan] { if (--scan->pending == 0 && gen == stressScanGen) fillStressors(*scan); };
+                for (const QString& cls : scan->classes)
+                    toolOutputAsync(this, "stress-ng", {"--class", cls + "?"}, [scan, cls, landed](const QString& out) {
+                        for (const QString& n : stressNgWords(out)) scan->classesOf[n] << cls;
+                        landed();
+                    });
+                toolOutputAsync(this, "stress-ng", {"--help"}, [scan, landed](const QString& out) {
+                    scan->help = out;
+                    landed();
+                });
+            });
+        });
+    }
+    void fillStressors(const StressorScan& scan) {
+        const QStringList ticked = selectedStressors();
+        cpuStressors->clear();
+        cpuClass->clear();
+        cpuClass->addItem("all", QString());
+        if (scan.names.isEmpty()) { cpuOptHelp->setText("stress-ng not found; only the CPU stressor is available"); return; }
+        for (const QString& cls : scan.classes) cpuClass->addItem(cls, cls);
+
+        // Each option goes to the longest stressor name it starts with:
+        // --cpu-online-affinity is cpu-online's, not cpu's
+        const QSet<QString> known(scan.names.begin(), scan.names.end());
+        QMap<QString, QStringList> opts;
+        for (const QString& h : scan.help.split('\n')) {
+            const QString t = h.trimmed(), opt = t.section(' ', 0, 0);
+            if (!opt.startsWith("--")) continue;
+            for (QString n = opt.mid(2); !n.isEmpty(); n = n.left(std::max(0, int(n.lastIndexOf('-'))))) {
+                if (known.contains(n)) { opts[n] << t.simplified(); break; }
+            }
+        }
+        for (const QString& n : scan.names) {
+            auto* it = new QListWidgetItem(n, cpuStressors);
+            it->setData(Qt::UserRole, n);
+            it->setData(Qt::UserRole+1, scan.classesOf.value(n));
+            it->setToolTip(opts.value(n).join('\n'));
+            it->setFlags(it->flags() | Qt::ItemIsUserCheckable);
+            it->setCheckState(ticked.contains(n) ? Qt::Checked : Qt::Unchecked);
+        }
+        cpuOptHelp->setText(QString("%1 stressors in %2 classes").arg(scan.names.size()).arg(scan.classes.size()));
+    }
+    QStringList selectedStressors() const {
+        QStringList out;
+        for (int i = 0; i < cpuStressors->count(); ++i)
+            if (cpuStressors->item(i)->checkState() == Qt::Checked) out << cpuStressors->item(i)->data(Qt::UserRole).toString();
+        return out;
+    }
+
     // --- Command building / deps ---
     QString testName() const {
         if (rbCpu->isChecked()) return "cpu";
@@ -577,7 +5352,11 @@ private:
             if (!need("stress-ng")) return {{},std::nullopt};
             int workers = std::max(1, cpuWorkers->value());
             int dur = std::max(5, cpuDuration->value());
-            return { {"stress-ng","--cpu",QString::number(workers),"--timeout",QString::number(dur)+"s"}, dur };
+            QStringList stressors = selectedStressors(); if (stressors.isEmpty()) stressors << "cpu";
+            QStringList cmd {"stress-ng"};
+            for (const QString& st : stressors) cmd << "--"+st << QString::number(workers);
+            cmd << QProcess::splitCommand(cpuStressOpts->text().trimmed()) << "--timeout" << QString::number(dur)+"s";
+            return { cmd, dur };
         }
         if (rbRam->isChecked()) {
             if (!need("stress-ng")) return {{},std::nullopt};
@@ -588,21 +5367,180 @@ private:
         }
         if (rbGpu->isChecked()) {
             if (!need("glmark2")) return {{},std::nullopt};
-            return { {"glmark2"}, std::nullopt };
+            QStringList cmd;
+            if (gpuSoftware->isChecked()) cmd << "env" << "LIBGL_ALWAYS_SOFTWARE=1" << "GALLIUM_DRIVER=llvmpipe";
+            cmd << "glmark2";
+            if (gpuOffscreen->isChecked()) cmd << "--off-screen";
+            // Each scene runs for 10 s by default; refined from the scene count as they complete
+            return { cmd, kGlmarkScenes * 10 };
         }
         if (rbDisk->isChecked()) {
-            if (!need("fio")) return {{},std::nullopt};
+            const int workload = diskWorkload->currentIndex();
+            if (workload == DiskThroughput && diskEngine->currentIndex() == 0 && !need("fio")) return {{},std::nullopt};
             QString size = diskSize->text().trimmed(); if (size.isEmpty()) size="1G";
             int runtime = std::max(5, diskRuntime->value());
             QString filename = diskFilename->text().trimmed(); if (filename.isEmpty()) filename = QDir::currentPath()+"/fio_testfile.bin";
+            const QString self = QCoreApplication::applicationFilePath();
+            const QString reuse = diskReuse->isChecked() ? "1" : "0";
+            if (workload == DiskWal) {
+                // The WAL segment is truncated and zero-filled: keep it away from the prepared test file
+                static const char* syncs[] = {"fdatasync", "fsync", "odsync"};
+                QString rec = walRecord->text().trimmed(); if (rec.isEmpty()) rec="4k";
+                return { {self, "--engine", "wal", "--file", filename + ".wal", "--size", size, "--record", rec,
+                          "--batch", QString::number(walBatch->value()), "--sync", syncs[walSync->currentIndex()],
+                          "--prealloc", walPrealloc->isChecked() ? "1" : "0",
+                          "--runtime", QString::number(runtime)}, runtime };
+            }
+            if (workload == DiskVerify) {
+                QString bs = verifyBs->text().trimmed(); if (bs.isEmpty()) bs="4k";
+                return { {self, "--engine", "verify", "--file", filename, "--size", size, "--bs", bs,
+                          "--passes", QString::number(verifyPasses->value()),
+                          "--direct", verifyDirect->isChecked() ? "1" : "0",
+                          "--drop-caches", verifyDrop->isChecked() ? "1" : "0", "--reuse", reuse}, std::nullopt };
+            }
+            if (workload == DiskCache) {
+                QString bs = cacheBs->text().trimmed(); if (bs.isEmpty()) bs="128k";
+                QString ra = cacheReadahead->text().remove(' '); if (ra.isEmpty()) ra="128,512,2048";
+                // cold seq + cold random per setting, then warm seq, warm random and the write pass
+                int phases = int(ra.split(',', Qt::SkipEmptyParts).size()) * 2 + 3;
+                return { {self, "--engine", "cache", "--file", filename, "--size", size, "--bs", bs,
+                          "--readahead", ra, "--runtime", QString::number(std::max(2, runtime/phases)),
+                          "--reuse", reuse}, std::nullopt };
+            }
+            if (workload == DiskMmap) {
+                QString bs = mmapBs->text().trimmed(); if (bs.isEmpty()) bs="4k";
+                int methods = mmapCompare->isChecked() ? 3 : 1;
+                int each = std::max(2, runtime/methods);
+                return { {self, "--engine", "mmap", "--file", filename, "--size", size, "--bs", bs,
+                          "--rw", mmapPattern->currentText(), "--advise", mmapAdvise->currentText(),
+                          "--populate", mmapPopulate->isChecked() ? "1" : "0",
+                          "--compare", mmapCompare->isChecked() ? "1" : "0",
+                          "--runtime", QString::number(each), "--reuse", reuse}, each*methods };
+            }
+            if (workload == DiskMeta) {
+                QString fsz = metaSize->text().trimmed(); if (fsz.isEmpty()) fsz="0";
+                return { {self, "--engine", "meta", "--dir", QFileInfo(filename).absolutePath(),
+                          "--files", QString::number(metaFiles->value()),
+                          "--fanout", QString::number(metaFanout->value()),
+                          "--threads", QString::number(metaThreads->value()), "--size", fsz}, std::nullopt };
+            }
+            const QStringList devices = selectedDevices();
+            if (diskEngine->currentIndex() > 0) {
+                static const char* engines[] = {"", "io_uring", "libaio", "psync"};
+                QString bs = diskBs->text().trimmed(); if (bs.isEmpty()) bs="4k";
+                // Like the fio path: devices that may not be written get the read-only form of the pattern
+                const bool writable = devices.isEmpty() || devicesWritable();
+                QString rw = diskPattern->currentText();
+                if (!writable) rw = rw.startsWith("rand") ? "randread" : "read";
+                QStringList cmd {self, "--engine", "disk",
+                                 "--file", devices.isEmpty() ? filename : devices.join(','), "--size", size, "--bs", bs,
+                                 "--rw", rw,
+                                 "--ioengine", engines[diskEngine->currentIndex()], "--reuse", reuse};
+                if (diskSqpoll->isEnabled() && diskSqpoll->isChecked()) cmd << "--sqpoll" << "1";
+                if (diskRawWrite->isChecked()) cmd << "--raw-write" << "1";
+                if (devices.size() > 1) {
+                    cmd << "--iodepth" << QString::number(diskDepth->value()) << "--runtime" << QString::number(runtime);
+                    return { cmd, runtime };
+                }
+                if (diskMatrix->isChecked() && writable) {
+                    // 60 cells (6 bs × seq/rand × 5 mixes); 2 s minimum each
+                    int cell = std::max(2, runtime/60);
+                    cmd << "--matrix" << "1" << "--iodepth" << QString::number(diskDepth->value())
+                        << "--runtime" << QString::number(cell);
+                    return { cmd, cell*60 };
+                }
+                if (diskSweep->isChecked()) {
+                    // 9 steps (QD 1..256); split the runtime across them, 2 s minimum each
+                    int step = std::max(2, runtime/9);
+                    cmd << "--qd-sweep" << "256" << "--runtime" << QString::number(step);
+                    return { cmd, step*9 };
+                }
+                cmd << "--iodepth" << QString::number(diskDepth->value()) << "--runtime" << QString::number(runtime);
+                return { cmd, runtime };
+            }
             QString ioengine = (QSysInfo::productType()=="linux") ? "libaio" : "psync";
-            return { {"fio","--name=randrw","--rw=randrw", "--size="+size,
+            if (!devices.isEmpty()) {
+                // One fio job per device, all running concurrently; options before the first --name are global
+                QStringList cmd {"fio", "--rw="+QString(devicesWritable() ? "randrw" : "randread"),
+                                 "--size="+size, "--runtime="+QString::number(runtime), "--time_based=1",
+                                 "--ioengine="+ioengine, "--direct=1",
+                                 "--output-format=json", "--status-interval=1"};
+                for (const QString& d : devices) cmd << "--name="+QFileInfo(d).fileName() << "--filename="+d;
+                return { cmd, runtime };
+            }
+            // fio would lay the file out itself on every run; prepare (or reuse) it first
+            return { {self, "--engine", "prep", "--file", filename, "--size", size, "--reuse", reuse, "--",
+                      "fio","--name=randrw","--rw=randrw", "--size="+size,
                       "--runtime="+QString::number(runtime), "--time_based=1",
-                      "--filename="+filename, "--ioengine="+ioengine, "--direct=1"}, runtime };
+                      "--filename="+filename, "--ioengine="+ioengine, "--direct=1",
+                      "--output-format=json", "--status-interval=1"}, runtime };
         }
         // net
         {
+            if (netEngine->currentIndex() != NetIperf) {
+                const bool local = netLocal->isChecked();
+                const bool inNs = local && !netNs->text().trimmed().isEmpty();
+                QString host = inNs ? "127.0.0.1" : local ? netIface->currentData().toString() : netServer->text().trimmed();
+                if (host.isEmpty() && local) host = "127.0.0.1";
+                if (host.isEmpty()) {
+                    QMessageBox::warning(this,"Input Error","Please enter the server IP (running hst --engine ... --role server), or tick Local server.");
+                    return {{},std::nullopt};
+                }
+                const int secs = netDuration->value();
+                QStringList cmd;
+                if (inNs) cmd << "ip" << "netns" << "exec" << netNs->text().trimmed();
+                const QString self = QCoreApplication::applicationFilePath();
+                const QString role = local ? "both" : "client";
+                if (netEngine->currentIndex() == NetUdp) {
+                    QString sizes = udpSizes->text().remove(' '); if (sizes.isEmpty()) sizes = "64,1472";
+                    const int n = std::max(1, int(sizes.split(',', Qt::SkipEmptyParts).size()));
+                    cmd << self << "--engine" << "udp" << "--role" << role << "--host" << host << "--sizes" << sizes
+                        << "--threads" << QString::number(udpThreads->value())
+                        << "--batch" << QString::number(udpBatch->value())
+                        << "--runtime" << QString::number(std::max(1, secs/n));
+                    return { cmd, std::max(1, secs/n)*n };
+                }
+                if (netEngine->currentIndex() == NetConnRate) {
+                    cmd << self << "--engine" << "connrate" << "--role" << role << "--host" << host
+                        << "--clients" << QString::number(crClients->value())
+                        << "--acceptors" << QString::number(crAcceptors->value())
+                        << "--backlog" << QString::number(crBacklog->value())
+                        << "--linger0" << (crLinger->isChecked() ? "1" : "0")
+                        << "--runtime" << QString::number(secs);
+                    return { cmd, secs };
+                }
+                if (netEngine->currentIndex() == NetRtt) {
+                    QString sizes = rttSizes->text().remove(' '); if (sizes.isEmpty()) sizes = "64";
+                    const int n = std::max(1, int(sizes.split(',', Qt::SkipEmptyParts).size())) *
+                                  (rttProto->currentIndex() == 0 ? 2 : 1);
+                    cmd << self << "--engine" << "rtt" << "--role" << role << "--host" << host
+                        << "--proto" << rttProto->currentText() << "--sizes" << sizes
+                        << "--conns" << QString::number(rttConns->value())
+                        << "--busy-poll" << QString::number(rttBusyPoll->value())
+                        << "--runtime" << QString::number(std::max(1, secs/n));
+                    return { cmd, std::max(1, secs/n)*n };
+                }
+                QString msg = tcpMsg->text().trimmed(); if (msg.isEmpty()) msg = "128k";
+                const int paths = tcpPath->currentIndex() == 0 ? 4 : 1;
+                cmd << self << "--engine" << "tcp" << "--role" << role << "--host" << host
+                    << "--streams" << QString::number(tcpStreams->value())
+                    << "--threads" << QString::number(tcpThreads->value())
+                    << "--path" << tcpPath->currentText() << "--msg" << msg
+                    << "--runtime" << QString::number(std::max(1, secs/paths));
+                return { cmd, std::max(1, secs/paths)*paths };
+            }
             if (!need("iperf3")) return {{},std::nullopt};
+            if (netLocal->isChecked()) {
+                // The host's interface addresses do not exist inside a namespace; use its loopback
+                QString bind = netNs->text().trimmed().isEmpty() ? netIface->currentData().toString() : QString();
+                if (bind.isEmpty()) bind = "127.0.0.1";
+                QStringList cmd {QCoreApplication::applicationFilePath(), "--engine", "iperf-local", "--bind", bind};
+                if (!netNs->text().trimmed().isEmpty()) cmd << "--netns" << netNs->text().trimmed();
+                auto extra = QProcess::splitCommand(netExtra->text().trimmed());
+                const auto secs = iperfJsonArgs(extra);
+                cmd << "--" << extra;
+                return { cmd, secs };
+            }
             QString srv = netServer->text().trimmed();
             if (srv.isEmpty()) {
                 QMessageBox::warning(this,"Input Error","Please enter the iperf3 server IP.");
@@ -610,9 +5548,37 @@ private:
             }
             QStringList cmd {"iperf3","-c",srv};
             auto extra = QProcess::splitCommand(netExtra->text().trimmed());
+            const auto secs = iperfJsonArgs(extra);
             cmd.append(extra);
-            return { cmd, std::nullopt };
+            return { cmd, secs };
+        }
+    }
+
+    // Asks iperf3 for machine-readable output unless the user already did:
+    // --json-stream (3.17+, one event per interval) when available, otherwise -J.
+    // Returns the expected run time (-t, default 10 s, plus -O omit seconds), or
+    // none when it is open-ended (-t 0) or set by a byte/block count (-n, -k).
+    static std::optional<int> iperfJsonArgs(QStringList& extra) {
+        static const bool stream = [] {
+            QRegularExpression re("iperf (\\d+)\\.(\\d+)");
+            auto m = re.match(toolOutput("iperf3", {"--version"}));
+            return m.hasMatch() && (m.captured(1).toInt() > 3 || (m.captured(1).toInt() == 3 && m.captured(2).toInt() >= 17));
+        }();
+        int secs = 10, omit = 0;
+        bool counted = false;
+        for (int i = 0; i < extra.size(); ++i) {
+            const QString opt = extra[i].section('=', 0, 0);
+            const QString val = extra[i].contains('=') ? extra[i].section('=', 1) : extra.value(i+1);
+            if (opt == "-t" || opt == "--time") secs = val.toInt();
+            if (opt == "-O" || opt == "--omit") omit = val.toInt();
+            if (opt == "-n" || opt == "--bytes" || opt == "-k" || opt == "--blockcount") counted = true;
+        }
+        if (!extra.contains("-J") && !extra.contains("--json") && !extra.contains("--json-stream")) {
+            if (stream) extra << "--json-stream" << "--forceflush";
+            else extra << "-J";
         }
+        if (counted || secs <= 0) return std::nullopt;
+        return secs + omit;
     }
 
     void checkDependenciesDialog() {
@@ -659,6 +5625,8 @@ protected:
 // -----------------------------
 
 int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--engine") == 0)
+        return runEngine(argc - 2, argv + 2);
     QApplication app(argc, argv);
     MainWindow w; w.show();
     return app.exec();